@@ -3,7 +3,9 @@ set -euo pipefail
 
 # build-coremark.sh — Build CoreMark benchmark for Atari MiNT
 # Produces 12 variants: {Os,O2} x {fastcall,no} x {default,experimental,experimental-reload}
+# per CPU (68000 in build-cm/, 68030/68040/68060 in build-cm/<cpu>/).
 # Experimental-reload variants use -mno-lra (legacy reload) and are suffixed with 'r'.
+# "run" boots every variant headlessly in Hatari and collects the logs.
 # Run from: ~/m68k-atari-mint-gcc/build/
 
 SRCDIR="$HOME/m68k-atari-mint-gcc"
@@ -16,6 +18,39 @@ OUTDIR="build-cm"
 CC_DEFAULT="m68k-atari-mintelf-gcc"
 CC_EXPERIMENTAL="$SRCDIR/build/build-host/gcc/xgcc -B$SRCDIR/build/build-host/gcc/"
 
+CPUS="68000 68030 68040 68060"
+HATARI="${HATARI:-hatari}"
+TOS_IMAGE="${TOS_IMAGE:-}"     # EmuTOS/TOS ROM; Hatari's default when empty
+RUNS=3                         # runs per variant, for variance
+RUN_TIMEOUT=900                # seconds per run
+
+# Output directory for one CPU (68000 stays in $OUTDIR for manual runs)
+cpu_dir() {
+    if [ "$1" = "68000" ]; then
+        echo "$OUTDIR"
+    else
+        echo "$OUTDIR/$1"
+    fi
+}
+
+# Parse "-cpu LIST" (comma or space separated) and "-n RUNS"
+parse_opts() {
+    while [ $# -gt 0 ]; do
+        case $1 in
+            -cpu) CPUS="${2//,/ }"; shift 2 ;;
+            -n)   RUNS="$2"; shift 2 ;;
+            *)    usage ;;
+        esac
+    done
+    local cpu
+    for cpu in $CPUS; do
+        case $cpu in
+            68000|68030|68040|68060) ;;
+            *) echo "Error: unsupported CPU $cpu (68000 68030 68040 68060)"; exit 1 ;;
+        esac
+    done
+}
+
 do_prepare() {
     mkdir -p tmp
 
@@ -34,6 +69,8 @@ do_prepare() {
 }
 
 do_build() {
+    parse_opts "$@"
+
     # Verify compilers exist
     if ! command -v "$CC_DEFAULT" &>/dev/null; then
         echo "Error: $CC_DEFAULT not found on PATH"
@@ -44,7 +81,33 @@ do_build() {
         exit 1
     fi
 
-    echo "=== Building CoreMark (12 variants) ==="
+    local cpu
+    for cpu in $CPUS; do
+        build_cpu "$cpu"
+    done
+
+    echo "=== Build complete ==="
+    echo ""
+    printf "%-22s %8s\n" "Variant" "Text"
+    printf "%-22s %8s\n" "-------" "----"
+    for cpu in $CPUS; do
+        local dir
+        dir=$(cpu_dir "$cpu")
+        for f in "$dir"/cm_*.tos; do
+            local text
+            text=$(m68k-atari-mintelf-size "$f" | awk 'NR==2{print $1}')
+            printf "%-22s %8d\n" "$cpu/$(basename "$f")" "$text"
+        done
+    done
+    echo ""
+}
+
+build_cpu() {
+    local cpu="$1"
+    local dir
+    dir=$(cpu_dir "$cpu")
+
+    echo "=== Building CoreMark for $cpu (12 variants) ==="
 
     build_one() {
         local name="$1" opt="$2" fastcall="$3" cc="$4" extra="$5"
@@ -56,9 +119,9 @@ do_build() {
         echo "  Building $name ..."
         make -j"$JOBS" -C "$WORKDIR" PORT_DIR=atari \
             CC="$cc" \
-            PORT_CFLAGS="$opt -mcpu=68000 -fomit-frame-pointer $extra" \
+            PORT_CFLAGS="$opt -mcpu=$cpu -fomit-frame-pointer $extra" \
             XCFLAGS="$fastcall_flag -DLOG_NAME=$logname" \
-            OUTNAME="$name"
+            OUTNAME="$name" REBUILD=1
     }
 
     #           name            opt    fastcall  compiler              extra
@@ -75,29 +138,111 @@ do_build() {
     build_one  cm_o2fe.tos     -O2    true      "$CC_EXPERIMENTAL"    ""
     build_one  cm_o2fer.tos    -O2    true      "$CC_EXPERIMENTAL"    "-mno-lra"
 
-    echo "=== Copying .tos files to $OUTDIR/ ==="
-    mkdir -p "$OUTDIR"
-    cp "$WORKDIR"/cm_*.tos "$OUTDIR"/
+    echo "=== Copying .tos files to $dir/ ==="
+    mkdir -p "$dir"
+    cp "$WORKDIR"/cm_*.tos "$dir"/
+}
 
-    echo "=== Build complete ==="
-    echo ""
-    printf "%-16s %8s\n" "Variant" "Text"
-    printf "%-16s %8s\n" "-------" "----"
-    for f in "$OUTDIR"/cm_*.tos; do
-        local text
-        text=$(m68k-atari-mintelf-size "$f" | awk 'NR==2{print $1}')
-        printf "%-16s %8d\n" "$(basename "$f")" "$text"
+# Hatari machine options for a CPU
+hatari_machine() {
+    case $1 in
+        68000) echo "--machine st --cpulevel 0 --memsize 4" ;;
+        68030) echo "--machine tt --cpulevel 3 --fpu 68882" ;;
+        68040) echo "--machine tt --cpulevel 4 --fpu internal" ;;
+        68060) echo "--machine tt --cpulevel 6 --fpu internal" ;;
+    esac
+}
+
+# Boot one .tos in Hatari until it reports its log, then stop the emulator.
+# CoreMark times itself with the emulated 200 Hz clock, so fast-forward and
+# host load do not change Iterations/Sec.
+run_one() {
+    local cpu="$1" dir="$2" tos="$3" k="$4"
+    local name="${tos%.tos}"
+    local log="$dir/$name.log"
+    local con="$dir/runs/$name.$k.con"
+    local prog
+    prog=$(echo "$tos" | tr '[:lower:]' '[:upper:]')
+
+    rm -f "$log"
+    # shellcheck disable=SC2046
+    SDL_VIDEODRIVER=dummy SDL_AUDIODRIVER=dummy "$HATARI" \
+        -c "$WORKDIR/hatari.cfg" $(hatari_machine "$cpu") \
+        ${TOS_IMAGE:+--tos "$TOS_IMAGE"} \
+        --cpu-exact on --sound off --fast-forward on --confirm-quit no \
+        --statusbar no --conout 2 \
+        -d "$dir" --auto "C:\\$prog" > "$con" 2>&1 &
+    local pid=$!
+
+    local waited=0
+    while kill -0 "$pid" 2>/dev/null; do
+        if grep -q "Results written to" "$con" 2>/dev/null; then
+            break
+        fi
+        if [ "$waited" -ge "$RUN_TIMEOUT" ]; then
+            echo "  $cpu/$name run $k: timeout" >&2
+            break
+        fi
+        sleep 1
+        waited=$((waited + 1))
     done
-    echo ""
+    kill "$pid" 2>/dev/null || true
+    wait "$pid" 2>/dev/null || true
+
+    if [ -f "$log" ]; then
+        cp "$log" "$dir/runs/$name.$k.log"
+    fi
 }
 
-do_compare() {
-    local logs=("$OUTDIR"/cm_*.log)
-    if [ ! -f "${logs[0]}" ]; then
-        echo "No log files found in $OUTDIR/cm_*.log"
+# All runs of one variant: run_variant <cpu> <dir> <tos>
+run_variant() {
+    local k
+    for ((k = 1; k <= RUNS; k++)); do
+        run_one "$1" "$2" "$3" "$k"
+    done
+    echo "  $1/$3 done"
+}
+
+do_run() {
+    parse_opts "$@"
+
+    if ! command -v "$HATARI" &>/dev/null; then
+        echo "Error: $HATARI not found on PATH (set HATARI=/path/to/hatari)"
         exit 1
     fi
 
+    mkdir -p "$WORKDIR"
+    : > "$WORKDIR/hatari.cfg"    # keep the user's ~/.config/hatari out of it
+
+    echo "=== Running CoreMark ($RUNS runs per variant, $JOBS in parallel) ==="
+    # Queue one job per variant (NUL-separated fields for xargs -0); each
+    # job does its runs back to back. xargs bounds the Hatari instances,
+    # since bash 3.2 has no wait -n.
+    local cpu queue="$WORKDIR/run.jobs"
+    : > "$queue"
+    for cpu in $CPUS; do
+        local dir
+        dir=$(cpu_dir "$cpu")
+        if [ ! -f "$dir/cm_os.tos" ]; then
+            echo "  $cpu: no .tos files in $dir/ — run $0 build first"
+            continue
+        fi
+        mkdir -p "$dir/runs"
+        rm -f "${dir:?}"/runs/cm_*
+        for f in "$dir"/cm_*.tos; do
+            printf '%s\0%s\0%s\0' "$cpu" "$dir" "$(basename "$f")" >> "$queue"
+        done
+    done
+
+    export -f run_variant run_one hatari_machine
+    export WORKDIR HATARI TOS_IMAGE RUNS RUN_TIMEOUT
+    xargs -0 -n 3 -P "$JOBS" bash -c 'run_variant "$@"' _ < "$queue" || true
+    echo "=== Run complete ==="
+}
+
+do_compare() {
+    parse_opts "$@"
+
     # Decode variant name into description columns
     decode_name() {
         local base="$1"            # e.g. cm_o2fe
@@ -132,94 +277,141 @@ do_compare() {
         echo "$opt $fc $cc"
     }
 
-    # Collect data: iter/sec filename opt fastcall compiler
+    # Iterations/Sec from one log
+    log_ips() {
+        tr -d '\r' < "$1" | awk '/^Iterations\/Sec/ { print $NF }'
+    }
+
+    # Collect data: cpu iter/sec sd% runs filename opt fastcall compiler
+    # Repeated runs from "run" (runs/*.N.log) give mean and std deviation;
+    # a hand-copied cm_*.log counts as a single run.
     local tmpfile
     tmpfile=$(mktemp)
-    for f in "${logs[@]}"; do
-        local ips
-        ips=$(tr -d '\r' < "$f" | awk '/^Iterations\/Sec/ { print $NF }')
-        if [ -z "$ips" ]; then
-            continue
-        fi
-        local base
-        base=$(basename "$f" .log)
-        local desc
-        desc=$(decode_name "$base")
-        echo "$ips $base $desc" >> "$tmpfile"
+    local cpu
+    for cpu in $CPUS; do
+        local dir
+        dir=$(cpu_dir "$cpu")
+        for f in "$dir"/cm_*.log; do
+            [ -f "$f" ] || continue
+            local base
+            base=$(basename "$f" .log)
+            local runs=("$dir"/runs/"$base".*.log)
+            [ -f "${runs[0]}" ] || runs=("$f")
+            local stats
+            stats=$(for r in "${runs[@]}"; do log_ips "$r"; done | awk '
+                NF { n++; s += $1; ss += $1 * $1 }
+                END {
+                    if (!n) exit
+                    m = s / n; v = ss / n - m * m
+                    printf "%.2f %.1f %d", m, (m > 0 && v > 0 ? sqrt(v) / m * 100 : 0), n
+                }')
+            if [ -z "$stats" ]; then
+                continue
+            fi
+            local desc
+            desc=$(decode_name "$base")
+            echo "$cpu $stats $base $desc" >> "$tmpfile"
+        done
     done
 
     if [ ! -s "$tmpfile" ]; then
-        echo "No Iterations/Sec data found in log files"
+        echo "No Iterations/Sec data found in log files under $OUTDIR/"
         rm -f "$tmpfile"
         exit 1
     fi
 
-    # Sort by iterations/sec descending, print table
+    # Sort by CPU, then iterations/sec descending, print table
     echo ""
     echo "Benchmark Results"
     echo "================="
     echo ""
-    printf "%-14s %8s  %-4s %-9s %s\n" "Variant" "Iter/s" "Opt" "Fastcall" "Compiler"
-    printf "%-14s %8s  %-4s %-9s %s\n" "-------" "------" "---" "--------" "--------"
-    sort -t' ' -k1 -rn "$tmpfile" | while read -r ips name opt fc cc; do
-        printf "%-14s %8s  %-4s %-9s %s\n" "$name" "$ips" "$opt" "$fc" "$cc"
+    printf "%-6s %-14s %9s %6s %4s  %-4s %-9s %s\n" "CPU" "Variant" "Iter/s" "+/-%" "Runs" "Opt" "Fastcall" "Compiler"
+    printf "%-6s %-14s %9s %6s %4s  %-4s %-9s %s\n" "---" "-------" "------" "----" "----" "---" "--------" "--------"
+    sort -t' ' -k1,1 -k2,2rn "$tmpfile" | while read -r cpu ips sd n name opt fc cc; do
+        printf "%-6s %-14s %9s %6s %4s  %-4s %-9s %s\n" "$cpu" "$name" "$ips" "$sd" "$n" "$opt" "$fc" "$cc"
     done
     echo ""
 
     rm -f "$tmpfile"
 
     # Text section size table, sorted smallest to largest
-    local bins=("$OUTDIR"/cm_*.tos)
-    if [ ! -f "${bins[0]}" ]; then
-        return
-    fi
-
     local tmpfile2
     tmpfile2=$(mktemp)
-    for f in "${bins[@]}"; do
-        local base
-        base=$(basename "$f" .tos)
-        local text
-        text=$(m68k-atari-mintelf-size "$f" | awk 'NR==2{print $1}')
-        local desc
-        desc=$(decode_name "$base")
-        echo "$text $base $desc" >> "$tmpfile2"
+    for cpu in $CPUS; do
+        local dir
+        dir=$(cpu_dir "$cpu")
+        for f in "$dir"/cm_*.tos; do
+            [ -f "$f" ] || continue
+            local base
+            base=$(basename "$f" .tos)
+            local text
+            text=$(m68k-atari-mintelf-size "$f" | awk 'NR==2{print $1}')
+            local desc
+            desc=$(decode_name "$base")
+            echo "$cpu $text $base $desc" >> "$tmpfile2"
+        done
     done
 
+    if [ ! -s "$tmpfile2" ]; then
+        rm -f "$tmpfile2"
+        return
+    fi
+
     echo "Text Section Sizes"
     echo "=================="
     echo ""
-    printf "%-14s %8s  %-4s %-9s %s\n" "Variant" "Text" "Opt" "Fastcall" "Compiler"
-    printf "%-14s %8s  %-4s %-9s %s\n" "-------" "----" "---" "--------" "--------"
-    sort -t' ' -k1 -n "$tmpfile2" | while read -r text name opt fc cc; do
-        printf "%-14s %8d  %-4s %-9s %s\n" "$name" "$text" "$opt" "$fc" "$cc"
+    printf "%-6s %-14s %8s  %-4s %-9s %s\n" "CPU" "Variant" "Text" "Opt" "Fastcall" "Compiler"
+    printf "%-6s %-14s %8s  %-4s %-9s %s\n" "---" "-------" "----" "---" "--------" "--------"
+    sort -t' ' -k1,1 -k2,2n "$tmpfile2" | while read -r cpu text name opt fc cc; do
+        printf "%-6s %-14s %8d  %-4s %-9s %s\n" "$cpu" "$name" "$text" "$opt" "$fc" "$cc"
     done
     echo ""
 
     rm -f "$tmpfile2"
 }
 
+do_all() {
+    parse_opts "$@"
+    local args=(-cpu "$CPUS" -n "$RUNS")
+    do_prepare
+    do_build "${args[@]}"
+    do_run "${args[@]}"
+    do_compare "${args[@]}"
+}
+
 do_clean() {
     echo "=== Cleaning CoreMark binaries ==="
-    rm -f "$WORKDIR"/cm_*.tos "$OUTDIR"/cm_*.tos
+    rm -f "$WORKDIR"/cm_*.tos "$OUTDIR"/cm_*.tos "$OUTDIR"/680?0/cm_*.tos
     echo "=== Clean complete ==="
 }
 
 usage() {
-    echo "Usage: $0 <command>"
+    echo "Usage: $0 <command> [-cpu LIST] [-n RUNS]"
     echo ""
     echo "Commands:"
     echo "  prepare  — Clone repo and apply patch"
-    echo "  build    — Build 12 CoreMark variants (default, experimental LRA, experimental reload)"
-    echo "  compare  — Compare benchmark results and text sizes from $OUTDIR/"
+    echo "  build    — Build 12 CoreMark variants per CPU (default, experimental LRA, experimental reload)"
+    echo "  run      — Boot every variant headlessly in Hatari, RUNS times each (default $RUNS)"
+    echo "  compare  — Compare benchmark results (mean, std deviation) and text sizes from $OUTDIR/"
+    echo "  all      — prepare, build, run and compare in one go"
     echo "  clean    — Remove generated .tos files"
+    echo ""
+    echo "Options:"
+    echo "  -cpu LIST  CPUs to build/run/compare (default: $CPUS)"
+    echo "  -n RUNS    Runs per variant for run/all"
+    echo ""
+    echo "Environment: HATARI (emulator binary), TOS_IMAGE (TOS/EmuTOS ROM)"
     exit 1
 }
 
-case "${1:-}" in
+cmd="${1:-}"
+[ $# -gt 0 ] && shift
+case "$cmd" in
     prepare) do_prepare ;;
-    build)   do_build ;;
-    compare) do_compare ;;
+    build)   do_build "$@" ;;
+    run)     do_run "$@" ;;
+    compare) do_compare "$@" ;;
+    all)     do_all "$@" ;;
     clean)   do_clean ;;
     *)       usage ;;
 esac
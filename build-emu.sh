@@ -0,0 +1,238 @@
+#!/bin/bash
+set -euo pipefail
+
+# build-emu.sh — Run test_cases.cpp on a Musashi 68000/030/040 core
+# Links every test function with emu/driver.cpp, runs the image headlessly with
+# emu/run68k.c, and compares measured cycles and result checksums between the
+# system compiler (old) and the built compiler (new).
+# Run from the repository root.
+
+MUSASHI_REPO="https://github.com/kstenerud/Musashi.git"
+WORKDIR="tmp/emu"
+MUSASHI_DIR="$WORKDIR/musashi"
+RUNNER="$WORKDIR/run68k"
+OUTPUT_DIR="tmp/test_cases"
+REGR_LOG="$OUTPUT_DIR/regressed_emu.log"
+MISMATCH_LOG="$OUTPUT_DIR/mismatch_emu.log"
+
+SOURCE="test_cases.cpp"
+CC_OLD="m68k-atari-mintelf-gcc"
+CC_NEW="./build-host/gcc/xgcc -B./build-host/gcc"
+COMMON_FLAGS="-mfastcall"
+DRIVER_FLAGS="-fno-inline -fno-exceptions -fno-rtti -fno-threadsafe-statics"
+
+# name:suffix:cpu — 68060 and ColdFire have no Musashi core
+VARIANTS=(
+    "O2:O2:000" "O2 -mshort:O2_short:000" "Os:Os:000" "Os -mshort:Os_short:000"
+    "O2 -m68030:O2_68030:030" "Os -m68030:Os_68030:030"
+    "O2 -m68040:O2_68040:040" "Os -m68040:Os_68040:040"
+    "O2 -m68060:O2_68060:-" "Os -m68060:Os_68060:-"
+    "O2 -mcpu=5475:O2_cf:-" "Os -mcpu=5475:Os_cf:-"
+)
+
+do_prepare() {
+    mkdir -p "$WORKDIR"
+
+    if [ ! -d "$MUSASHI_DIR" ]; then
+        echo "=== Cloning Musashi ==="
+        git clone "$MUSASHI_REPO" "$MUSASHI_DIR"
+    fi
+
+    # Stock m68kconf.h lets odd-address word/long accesses succeed; the
+    # 68000 core must raise an address error so misaligned code faults
+    echo "=== Enabling address error emulation ==="
+    perl -pi -e 's/^(#define\s+M68K_EMULATE_ADDRESS_ERROR\s+)OPT_OFF/${1}OPT_ON/' "$MUSASHI_DIR/m68kconf.h"
+    if ! grep -Eq '^#define[[:space:]]+M68K_EMULATE_ADDRESS_ERROR[[:space:]]+OPT_ON' "$MUSASHI_DIR/m68kconf.h"; then
+        echo "Error: could not enable M68K_EMULATE_ADDRESS_ERROR in $MUSASHI_DIR/m68kconf.h"
+        exit 1
+    fi
+
+    echo "=== Generating opcode tables ==="
+    gcc -O2 -o "$MUSASHI_DIR/m68kmake" "$MUSASHI_DIR/m68kmake.c"
+    (cd "$MUSASHI_DIR" && ./m68kmake)
+
+    echo "=== Building run68k ==="
+    local srcs=("$MUSASHI_DIR/m68kcpu.c" "$MUSASHI_DIR/m68kops.c" "$MUSASHI_DIR/m68kdasm.c")
+    if [ -f "$MUSASHI_DIR/softfloat/softfloat.c" ]; then
+        srcs+=("$MUSASHI_DIR/softfloat/softfloat.c")
+    fi
+    gcc -O2 -I"$MUSASHI_DIR" -o "$RUNNER" emu/run68k.c "${srcs[@]}" -lm
+
+    echo "=== Prepare complete ==="
+}
+
+# Build one flat image: build_image <compiler> <flags> <output.bin>
+build_image() {
+    local cc="$1" flags="$2" out="$3"
+    local obj="${out%.bin}.o.d"
+    mkdir -p "$obj"
+    # shellcheck disable=SC2086
+    $cc $COMMON_FLAGS $flags -c emu/crt0.S -o "$obj/crt0.o" &&
+    $cc $COMMON_FLAGS $flags -fno-builtin -fno-tree-loop-distribute-patterns -c emu/libc.c -o "$obj/libc.o" &&
+    $cc $COMMON_FLAGS $flags -c emu/stubs.c -o "$obj/stubs.o" &&
+    $cc $COMMON_FLAGS $flags $DRIVER_FLAGS -I"$WORKDIR" -c emu/driver.cpp -o "$obj/driver.o" &&
+    $cc $COMMON_FLAGS $flags -nostdlib -static -T emu/emu.ld \
+        "$obj/crt0.o" "$obj/driver.o" "$obj/stubs.o" "$obj/libc.o" -lgcc -o "$out"
+}
+
+# Run one compiler for one variant; writes <suffix>_<which>.emu or returns 1
+run_one() {
+    local which="$1" cc="$2" flags="$3" suffix="$4" cpu="$5"
+    local image="$WORKDIR/${suffix}_${which}.bin"
+    local result="$OUTPUT_DIR/${suffix}_${which}.emu"
+    rm -f "$result"
+    if ! build_image "$cc" "$flags" "$image" > "$WORKDIR/${suffix}_${which}.log" 2>&1; then
+        return 1
+    fi
+    "$RUNNER" -c "$cpu" "$image" "$WORKDIR/test_names.txt" > "$result" 2>> "$WORKDIR/${suffix}_${which}.log"
+}
+
+# Compare two .emu files (same test order).
+# Prints "old_sum new_sum regr/impr bad fail"; appends details to the logs.
+# Sums only cover functions that ran to completion with both compilers.
+compare_emu() {
+    local old_file="$1" new_file="$2" variant="$3"
+    paste "$old_file" "$new_file" | awk -F'\t' -v var="$variant" -v regr="$REGR_LOG" -v mism="$MISMATCH_LOG" '
+        function done_ok(s) { return s == "ok" || s == "stray" }
+        {
+            if ($8 == "fault" || $8 == "timeout") fail++
+            if (!done_ok($4) || !done_ok($8)) next
+            old = $2 + 0; new = $6 + 0
+            os += old; ns += new
+            if (new > old) { reg++; print var "\t" $1 "\t" old "\t" new "\t+" new - old >> regr }
+            else if (new < old) imp++
+            if ($3 != $7) { bad++; print var "\t" $1 "\t" $3 "\t" $7 >> mism }
+        }
+        END { print os + 0, ns + 0, reg + 0 "/" imp + 0, bad + 0, fail + 0 }'
+}
+
+do_run() {
+    local show_reload=false
+    for arg in "$@"; do
+        case $arg in
+            -reload) show_reload=true ;;
+            *) usage ;;
+        esac
+    done
+
+    if [ ! -x "$RUNNER" ]; then
+        echo "Error: $RUNNER not found — run $0 prepare first"
+        exit 1
+    fi
+    if ! command -v "$CC_OLD" &>/dev/null; then
+        echo "Error: $CC_OLD not found on PATH"
+        exit 1
+    fi
+    if [ ! -x ./build-host/gcc/xgcc ]; then
+        echo "Error: ./build-host/gcc/xgcc not found — run ./build-gcc.sh build first"
+        exit 1
+    fi
+
+    mkdir -p "$WORKDIR" "$OUTPUT_DIR"
+    > "$REGR_LOG"
+    > "$MISMATCH_LOG"
+
+    # Test list: every test_* function defined in test_cases.cpp
+    sed -nE 's/^[[:space:]]*([A-Za-z_][^=;]*[ *&])?(test_[A-Za-z0-9_]+)\(.*$/\2/p' "$SOURCE" |
+        grep -v '^return' > "$WORKDIR/test_names.txt"
+    sed 's/.*/EMU_TEST(&)/' "$WORKDIR/test_names.txt" > "$WORKDIR/test_list.h"
+    echo "=== Running $(wc -l < "$WORKDIR/test_names.txt") test functions ==="
+
+    local rows=()
+    for variant in "${VARIANTS[@]}"; do
+        local display_name="${variant%%:*}"
+        local rest="${variant#*:}"
+        local suffix="${rest%%:*}"
+        local cpu="${rest##*:}"
+        local flags="-${display_name}"
+
+        if [ "$cpu" = "-" ]; then
+            rows+=("$display_name|n/a")
+            continue
+        fi
+        echo "  $display_name (cpu $cpu)"
+
+        run_one old "$CC_OLD" "$flags" "$suffix" "$cpu" || true
+        run_one new "$CC_NEW" "$flags" "$suffix" "$cpu" || true
+        if $show_reload; then
+            run_one reload "$CC_NEW" "$flags -mno-lra" "$suffix" "$cpu" || true
+        fi
+
+        local old_file="$OUTPUT_DIR/${suffix}_old.emu"
+        local new_file="$OUTPUT_DIR/${suffix}_new.emu"
+        local reload_file="$OUTPUT_DIR/${suffix}_reload.emu"
+        if [ ! -s "$old_file" ] || [ ! -s "$new_file" ]; then
+            rows+=("$display_name|ERR")
+            continue
+        fi
+        local row
+        row="$display_name|$(compare_emu "$old_file" "$new_file" "$display_name")"
+        if $show_reload; then
+            if [ -s "$reload_file" ]; then
+                row="$row|$(compare_emu "$new_file" "$reload_file" "$display_name (reload)" | awk '{print $2}')"
+            else
+                row="$row|ERR"
+            fi
+        fi
+        rows+=("$row")
+    done
+
+    echo ""
+    echo "Measured Cycle Comparison (Musashi)"
+    echo "==================================="
+    echo ""
+    if $show_reload; then
+        printf "%-22s %9s %9s %7s %8s %5s %5s %9s\n" "Variant" "Old" "New" "Diff%" "Regr" "Bad" "Fail" "Reload"
+        printf "%-22s %9s %9s %7s %8s %5s %5s %9s\n" "-------" "---" "---" "-----" "----" "---" "----" "------"
+    else
+        printf "%-22s %9s %9s %7s %8s %5s %5s\n" "Variant" "Old" "New" "Diff%" "Regr" "Bad" "Fail"
+        printf "%-22s %9s %9s %7s %8s %5s %5s\n" "-------" "---" "---" "-----" "----" "---" "----"
+    fi
+    for row in "${rows[@]}"; do
+        local name="${row%%|*}"
+        local data="${row#*|}"
+        if [ "$data" = "n/a" ] || [ "$data" = "ERR" ]; then
+            printf "%-22s %9s\n" "$name" "$data"
+            continue
+        fi
+        local old new regr bad fail reload=""
+        read -r old new regr bad fail <<< "${data%%|*}"
+        [[ "$data" == *"|"* ]] && reload="${data##*|}"
+        local pct="0.0"
+        if [ "$old" -gt 0 ]; then
+            pct=$(awk "BEGIN {printf \"%.1f\", (($new - $old) / $old) * 100}")
+        fi
+        if $show_reload; then
+            printf "%-22s %9d %9d %6s%% %8s %5d %5d %9s\n" "$name" "$old" "$new" "$pct" "$regr" "$bad" "$fail" "$reload"
+        else
+            printf "%-22s %9d %9d %6s%% %8s %5d %5d\n" "$name" "$old" "$new" "$pct" "$regr" "$bad" "$fail"
+        fi
+    done
+    echo ""
+    echo "Regr: functions slower/faster with new; Bad: checksum differs from old;"
+    echo "Fail: new faulted or timed out. Details: $REGR_LOG, $MISMATCH_LOG"
+    echo "Per-function results: $OUTPUT_DIR/*.emu (name cycles checksum status)"
+}
+
+do_clean() {
+    echo "=== Cleaning emulator images and results ==="
+    rm -rf "$WORKDIR"/*.bin "$WORKDIR"/*.o.d "$WORKDIR"/*.log "$OUTPUT_DIR"/*.emu
+    echo "=== Clean complete ==="
+}
+
+usage() {
+    echo "Usage: $0 <command> [options]"
+    echo ""
+    echo "Commands:"
+    echo "  prepare        — Clone Musashi and build the run68k runner"
+    echo "  run [-reload]  — Build and run test_cases.cpp images for old and new (and reload) compilers"
+    echo "  clean          — Remove images and .emu results"
+    exit 1
+}
+
+case "${1:-}" in
+    prepare) do_prepare ;;
+    run)     shift; do_run "$@" ;;
+    clean)   do_clean ;;
+    *)       usage ;;
+esac
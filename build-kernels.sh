@@ -0,0 +1,359 @@
+#!/bin/bash
+set -euo pipefail
+
+# build-kernels.sh — Benchmark real kernels from the mikros packages
+# Compiles hot loops from zlib, libpng, mpg123, libxmp-lite, SDL 1.2 and
+# libcmini (the same tarballs build-mikros.sh downloads) with each compiler,
+# runs them with fixed inputs on the Musashi runner from build-emu.sh, and
+# reports cycles per kernel and text size per package.
+# Run from the repository root.
+
+DOWNLOAD_DIR="$HOME/Downloads/mikro"
+WORKDIR="tmp/kernels"
+SRC="$WORKDIR/src"
+RESULTS="$WORKDIR/results"
+RUNNER="tmp/emu/run68k"
+TOOL_PREFIX=m68k-atari-mintelf
+
+CC_OLD="m68k-atari-mintelf-gcc"
+CC_NEW="./build-host/gcc/xgcc -B./build-host/gcc"
+
+# Package code is built the way build-mikros.sh builds it; sections let
+# --gc-sections drop everything the drivers do not reach.
+KERNEL_FLAGS="-fomit-frame-pointer -ffunction-sections -fdata-sections"
+
+# Packages (driver emu/kernels/<name>.c) and variants name:flags:cpu
+PACKAGES=(zlib png mpg123 xmp sdl cmini)
+VARIANTS=(
+    "O2 68000:-O2 -m68000:000"
+    "Os 68000:-Os -m68000:000"
+    "O2 68020-60:-O2 -m68020-60:030"
+)
+
+# libcmini functions driven by emu/kernels/cmini.c
+CMINI_FUNCS="memcpy memset memcmp strlen strcmp strcpy"
+
+# Newest tarball matching a pattern in $DOWNLOAD_DIR
+tarball() {
+    local f
+    f=$(ls "$DOWNLOAD_DIR"/$1 2>/dev/null | sort -V | tail -1 || true)
+    if [ -z "$f" ]; then
+        echo "Error: $DOWNLOAD_DIR/$1 not found — run ./build-mikros.sh --download first" >&2
+        exit 1
+    fi
+    echo "$f"
+}
+
+extract() {
+    local pattern="$1" dir="$SRC/$2"
+    rm -rf "$dir"
+    mkdir -p "$dir"
+    tar xf "$(tarball "$pattern")" -C "$dir" --strip-components=1
+}
+
+# Fixed deflate stream: 32 KB of pseudo-text from a fixed word list and LCG
+gen_zlib_input() {
+    python3 - "$WORKDIR/zlib_input.h" <<'EOF'
+import sys, zlib
+words = b"the of and to in is that for it as with was on be by this are from at or an which have not".split()
+state, out = 1, bytearray()
+while len(out) < 32768:
+    state = (state * 1103515245 + 12345) & 0xffffffff
+    out += words[(state >> 16) % len(words)] + (b".\n" if (state >> 8) % 11 == 0 else b" ")
+plain = bytes(out[:32768])
+data = zlib.compress(plain, 9)
+with open(sys.argv[1], "w") as f:
+    f.write("/* Generated by build-kernels.sh prepare */\n")
+    f.write("#define ZLIB_PLAIN_SIZE %d\n" % len(plain))
+    f.write("static const unsigned char zlib_input[%d] = {\n" % len(data))
+    for i in range(0, len(data), 16):
+        f.write("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",\n")
+    f.write("};\n")
+EOF
+}
+
+# The row filters are static in pngrutil.c: copy them out as global functions
+gen_png_filters() {
+    local dir="$SRC/libpng"
+    cp "$dir/scripts/pnglibconf.h.prebuilt" "$dir/pnglibconf.h"
+    {
+        echo "/* Extracted from libpng pngrutil.c by build-kernels.sh prepare */"
+        echo "#include \"png.h\""
+        echo "#define PNG_UNUSED(param) (void)param;"
+        echo "#define png_debug(l, m) ((void)0)"
+        echo ""
+        awk '
+            hold && /^png_read_filter_row_[a-z0-9_]+\(/ { print "void"; copy = 1 }
+            copy { print; if (/^}/) { copy = 0; print "" } }
+            { hold = /^static void/ }
+        ' "$dir/pngrutil.c"
+    } > "$dir/png_filters.c"
+}
+
+do_prepare() {
+    if [ ! -x "$RUNNER" ]; then
+        echo "Error: $RUNNER not found — run ./build-emu.sh prepare first"
+        exit 1
+    fi
+    if ! command -v "$CC_OLD" &>/dev/null; then
+        echo "Error: $CC_OLD not found on PATH"
+        exit 1
+    fi
+    mkdir -p "$SRC"
+
+    echo "=== Extracting package sources ==="
+    extract "zlib-*.tar.gz" zlib
+    extract "libpng-*.tar.gz" libpng
+    extract "mpg123-*.tar.bz2" mpg123
+    extract "libxmp-lite-*.tar.gz" libxmp-lite
+    extract "SDL-1.2-*.tar.gz" SDL
+    extract "libcmini-*.tar.gz" libcmini
+
+    echo "=== Generating inputs ==="
+    gen_zlib_input
+    gen_png_filters
+
+    # config.h / SDL_config.h come from the packages' own configure, run
+    # once with the stock compiler as in build-mikros.sh
+    echo "=== Configuring mpg123 ==="
+    (cd "$SRC/mpg123" && CC="$CC_OLD" CFLAGS="-O2 -m68000" ./configure --host=${TOOL_PREFIX} \
+        --with-cpu=generic_nofpu --disable-components --enable-libmpg123 \
+        --enable-network=no --disable-messages --disable-largefile) > "$WORKDIR/configure-mpg123.log" 2>&1
+    echo "=== Configuring SDL ==="
+    (cd "$SRC/SDL" && CC="$CC_OLD" CFLAGS="-O2 -m68000" ./configure --host=${TOOL_PREFIX} \
+        --disable-video-opengl --disable-threads) > "$WORKDIR/configure-sdl.log" 2>&1
+
+    echo "=== Prepare complete ==="
+}
+
+# Package sources for one kernel driver
+package_sources() {
+    case $1 in
+        zlib)   local d="$SRC/zlib"
+                echo "$d/inflate.c $d/inftrees.c $d/inffast.c $d/zutil.c $d/adler32.c $d/crc32.c" ;;
+        png)    echo "$SRC/libpng/png_filters.c" ;;
+        mpg123) echo "$SRC/mpg123/src/libmpg123/dct64.c $SRC/mpg123/src/libmpg123/tabinit.c" ;;
+        xmp)    echo "$SRC/libxmp-lite/src/mix_all.c" ;;
+        sdl)    local v="$SRC/SDL/src/video"
+                echo "$v/SDL_surface.c $v/SDL_pixels.c $v/SDL_blit.c $v/SDL_blit_0.c $v/SDL_blit_1.c" \
+                     "$v/SDL_blit_A.c $v/SDL_blit_N.c $v/SDL_RLEaccel.c $SRC/SDL/src/cpuinfo/SDL_cpuinfo.c" ;;
+        cmini)  local fn
+                for fn in $CMINI_FUNCS; do
+                    [ -f "$SRC/libcmini/sources/$fn.c" ] && echo "$SRC/libcmini/sources/$fn.c"
+                done ;;
+    esac
+}
+
+# Include paths and defines for the package sources and the driver
+package_flags() {
+    case $1 in
+        zlib)   echo "-DZ_SOLO -I$SRC/zlib -I$WORKDIR" ;;
+        png)    echo "-I$SRC/libpng" ;;
+        mpg123) local m="$SRC/mpg123/src"
+                echo "-I$m -I$m/libmpg123 -I$m/compat -I$m/include" ;;
+        xmp)    local x="$SRC/libxmp-lite"
+                echo "-I$x/include -I$x/src -DLIBXMP_CORE_PLAYER -DLIBXMP_STATIC" ;;
+        sdl)    local s="$SRC/SDL"
+                echo "-I$s/include -I$s/src -I$s/src/video" ;;
+        cmini)  local fn flags="-I$SRC/libcmini/include -fno-builtin"
+                for fn in $CMINI_FUNCS; do
+                    if [ -f "$SRC/libcmini/sources/$fn.c" ]; then
+                        flags="$flags -D$fn=cmini_$fn -DHAVE_CMINI_$(echo "$fn" | tr '[:lower:]' '[:upper:]')"
+                    fi
+                done
+                echo "$flags" ;;
+    esac
+}
+
+# Build one image: build_image <compiler> <flags> <package> <objdir> <image>
+# Writes the summed text size of the package objects to <objdir>/text.
+build_image() {
+    local cc="$1" flags="$2" pkg="$3" obj="$4" out="$5"
+    local pflags src objs=()
+    pflags=$(package_flags "$pkg")
+    rm -rf "$obj"
+    mkdir -p "$obj/pkg"
+
+    # shellcheck disable=SC2086
+    for src in $(package_sources "$pkg"); do
+        local o
+        o="$obj/pkg/$(basename "${src%.c}").o"
+        $cc $flags $KERNEL_FLAGS $pflags -c "$src" -o "$o" || return 1
+        objs+=("$o")
+    done
+    [ ${#objs[@]} -gt 0 ] || return 1
+    ${TOOL_PREFIX}-size "${objs[@]}" | awk 'NR > 1 { t += $1 } END { print t + 0 }' > "$obj/text"
+
+    # shellcheck disable=SC2086
+    $cc $flags -c emu/crt0.S -o "$obj/crt0.o" &&
+    $cc $flags -fno-builtin -fno-tree-loop-distribute-patterns -c emu/libc.c -o "$obj/libc.o" &&
+    $cc $flags -fno-builtin -c emu/kernels/runtime.c -o "$obj/runtime.o" &&
+    $cc $flags $KERNEL_FLAGS $pflags -c "emu/kernels/$pkg.c" -o "$obj/driver.o" &&
+    $cc $flags -nostdlib -static -T emu/emu.ld -Wl,--gc-sections \
+        "$obj/crt0.o" "$obj/driver.o" "${objs[@]}" "$obj/runtime.o" "$obj/libc.o" -lgcc -o "$out"
+}
+
+# Run one package for one variant and compiler
+run_one() {
+    local which="$1" cc="$2" flags="$3" suffix="$4" cpu="$5" pkg="$6"
+    local tag="${pkg}_${suffix}_${which}"
+    local obj="$WORKDIR/obj/$tag"
+    rm -f "$RESULTS/$tag.emu" "$RESULTS/$tag.text"
+    if ! build_image "$cc" "$flags" "$pkg" "$obj" "$obj.bin" > "$RESULTS/$tag.log" 2>&1; then
+        echo "    $pkg ($which): build failed, see $RESULTS/$tag.log"
+        return 1
+    fi
+    cp "$obj/text" "$RESULTS/$tag.text"
+    "$RUNNER" -c "$cpu" "$obj.bin" "$WORKDIR/$pkg.names" > "$RESULTS/$tag.emu" 2>> "$RESULTS/$tag.log"
+}
+
+do_run() {
+    local show_reload=false
+    for arg in "$@"; do
+        case $arg in
+            -reload) show_reload=true ;;
+            *) usage ;;
+        esac
+    done
+
+    if [ ! -f "$WORKDIR/zlib_input.h" ]; then
+        echo "Error: sources not prepared — run $0 prepare first"
+        exit 1
+    fi
+    if [ ! -x ./build-host/gcc/xgcc ]; then
+        echo "Error: ./build-host/gcc/xgcc not found — run ./build-gcc.sh build first"
+        exit 1
+    fi
+
+    mkdir -p "$RESULTS" "$WORKDIR/obj"
+    local compilers=(old new)
+    $show_reload && compilers+=(reload)
+
+    local pkg variant
+    for pkg in "${PACKAGES[@]}"; do
+        sed -nE 's/^[[:space:]]*\{ "([A-Za-z0-9_]+)",.*/\1/p' "emu/kernels/$pkg.c" > "$WORKDIR/$pkg.names"
+    done
+
+    for variant in "${VARIANTS[@]}"; do
+        local name="${variant%%:*}"
+        local rest="${variant#*:}"
+        local flags="${rest%%:*}"
+        local cpu="${rest##*:}"
+        local suffix="${name// /_}"
+        echo "=== $name (cpu $cpu) ==="
+        for pkg in "${PACKAGES[@]}"; do
+            local which
+            for which in "${compilers[@]}"; do
+                case $which in
+                    old)    run_one old "$CC_OLD" "$flags" "$suffix" "$cpu" "$pkg" || true ;;
+                    new)    run_one new "$CC_NEW" "$flags" "$suffix" "$cpu" "$pkg" || true ;;
+                    reload) run_one reload "$CC_NEW" "$flags -mno-lra" "$suffix" "$cpu" "$pkg" || true ;;
+                esac
+            done
+        done
+    done
+
+    report "${compilers[@]}"
+}
+
+# Print the cycle and text tables from $RESULTS
+report() {
+    local compilers=("$@")
+    local with_reload=false
+    [ ${#compilers[@]} -gt 2 ] && with_reload=true
+
+    echo ""
+    echo "Kernel Cycles (Musashi)"
+    echo "======================="
+    echo ""
+    printf "%-22s %-12s %10s %10s %7s %4s" "Kernel" "Variant" "Old" "New" "Diff%" "Bad"
+    $with_reload && printf " %10s" "Reload"
+    printf "\n"
+    printf "%-22s %-12s %10s %10s %7s %4s" "------" "-------" "---" "---" "-----" "---"
+    $with_reload && printf " %10s" "------"
+    printf "\n"
+
+    local variant pkg
+    for variant in "${VARIANTS[@]}"; do
+        local name="${variant%%:*}"
+        local suffix="${name// /_}"
+        for pkg in "${PACKAGES[@]}"; do
+            local old="$RESULTS/${pkg}_${suffix}_old.emu"
+            local new="$RESULTS/${pkg}_${suffix}_new.emu"
+            local reload="$RESULTS/${pkg}_${suffix}_reload.emu"
+            if [ ! -s "$old" ] || [ ! -s "$new" ]; then
+                printf "%-22s %-12s %10s\n" "$pkg" "$name" "ERR"
+                continue
+            fi
+            [ -s "$reload" ] || reload=/dev/null
+            # name cycles checksum status, one line per kernel, same order
+            awk -F'\t' -v var="$name" -v rl="$with_reload" '
+                FILENAME == ARGV[1] { oc[FNR] = $2; os[FNR] = $4; oh[FNR] = $3; n[FNR] = $1; next }
+                FILENAME == ARGV[2] { nc[FNR] = $2; ns[FNR] = $4; nh[FNR] = $3; cnt = FNR; next }
+                { rc[FNR] = $2; rs[FNR] = $4 }
+                END {
+                    for (i = 1; i <= cnt; i++) {
+                        if (os[i] != "ok" && os[i] != "stray") { printf "%-22s %-12s %10s\n", n[i], var, os[i]; continue }
+                        if (ns[i] != "ok" && ns[i] != "stray") { printf "%-22s %-12s %10d %10s\n", n[i], var, oc[i], ns[i]; continue }
+                        pct = oc[i] > 0 ? (nc[i] - oc[i]) * 100 / oc[i] : 0
+                        printf "%-22s %-12s %10d %10d %6.1f%% %4s", n[i], var, oc[i], nc[i], pct, oh[i] == nh[i] ? "" : "X"
+                        if (rl == "true")
+                            printf " %10s", (rs[i] == "ok" || rs[i] == "stray") ? rc[i] : (rs[i] == "" ? "-" : rs[i])
+                        printf "\n"
+                    }
+                }' "$old" "$new" "$reload"
+        done
+    done
+
+    echo ""
+    echo "Package Text Size (bytes, kernel objects only)"
+    echo "=============================================="
+    echo ""
+    printf "%-10s %-12s %8s %8s %7s\n" "Package" "Variant" "Old" "New" "Diff%"
+    printf "%-10s %-12s %8s %8s %7s\n" "-------" "-------" "---" "---" "-----"
+    for variant in "${VARIANTS[@]}"; do
+        local name="${variant%%:*}"
+        local suffix="${name// /_}"
+        for pkg in "${PACKAGES[@]}"; do
+            local old_t="$RESULTS/${pkg}_${suffix}_old.text"
+            local new_t="$RESULTS/${pkg}_${suffix}_new.text"
+            if [ ! -s "$old_t" ] || [ ! -s "$new_t" ]; then
+                printf "%-10s %-12s %8s\n" "$pkg" "$name" "ERR"
+                continue
+            fi
+            local o n
+            o=$(cat "$old_t")
+            n=$(cat "$new_t")
+            printf "%-10s %-12s %8d %8d %6s%%\n" "$pkg" "$name" "$o" "$n" \
+                "$(awk "BEGIN {printf \"%.1f\", ($o > 0 ? ($n - $o) * 100 / $o : 0)}")"
+        done
+    done
+    echo ""
+    echo "Bad: X when the new compiler's output checksum differs from old."
+    echo "Per-kernel results: $RESULTS/<package>_<variant>_<cc>.emu"
+}
+
+do_clean() {
+    echo "=== Cleaning kernel images and results ==="
+    rm -rf "$WORKDIR/obj" "$RESULTS"
+    echo "=== Clean complete ==="
+}
+
+usage() {
+    echo "Usage: $0 <command> [options]"
+    echo ""
+    echo "Commands:"
+    echo "  prepare        — Extract package sources from $DOWNLOAD_DIR and configure them"
+    echo "  run [-reload]  — Build and run the kernels with old and new (and reload) compilers"
+    echo "  clean          — Remove images and results"
+    echo ""
+    echo "Packages: ${PACKAGES[*]} (drivers in emu/kernels/)"
+    exit 1
+}
+
+case "${1:-}" in
+    prepare) do_prepare ;;
+    run)     shift; do_run "$@" ;;
+    clean)   do_clean ;;
+    *)       usage ;;
+esac
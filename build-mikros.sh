@@ -3,6 +3,10 @@ set -o pipefail
 
 # ============================================================================
 # build-mikros.sh — Build 17 packages with both non-sjlj and sjlj compilers
+#
+# Independent packages, the three multilib targets of a package and the two
+# compilers all build concurrently (--jobs=N packages at a time, --serial for
+# one thing at a time). PKG_DEPS orders dependent packages.
 # ============================================================================
 
 # --- Configuration ---
@@ -12,7 +16,10 @@ WORK_DIR="/tmp/build-mikros-$$"
 SCRIPTS_DIR="$HOME/build-scripts"
 SYSROOT=$(/opt/cross-mint/bin/m68k-atari-mintelf-gcc -print-sysroot)
 TOOL_PREFIX=m68k-atari-mintelf
-MAKEFLAGS="-j8"
+NCPU=$(sysctl -n hw.ncpu 2>/dev/null || nproc 2>/dev/null || echo 4)
+# Several packages build at once; the load limit keeps their makes from
+# oversubscribing the machine
+MAKEFLAGS="-j8 -l$NCPU"
 export MAKEFLAGS
 
 # Package versions
@@ -59,14 +66,45 @@ PKG_NAMES=(
 )
 PKG_COUNT=${#PKG_NAMES[@]}
 
+# Build dependencies, parallel to PKG_NAMES. Packages compile against the
+# sysroot, not against each other's build trees, so an edge only delays the
+# dependent until its dependency has built with the same compiler.
+PKG_DEPS=(
+    ""              # zlib
+    ""              # gemlib
+    "gemlib"        # LDG
+    "gemlib"        # SDL-1.2
+    ""              # libxmp
+    ""              # libxmp-lite
+    ""              # physfs
+    "gemlib"        # cflib
+    ""              # libcmini
+    ""              # mintlib
+    ""              # ASAP
+    ""              # mpg123
+    ""              # uthread
+    "zlib"          # libpng
+    ""              # usound
+    "SDL-1.2 libpng zlib"  # SDL_image
+    "SDL-1.2"       # SDL_mixer
+)
+
+# Multilib targets: name:cpu_flags:lib_suffix
+MULTILIBS=("m68000:-m68000:" "m68020-60:-m68020-60:/m68020-60" "m5475:-mcpu=5475:/m5475")
+
 # Result tracking arrays
-declare -a TIME_BUILD1 TIME_BUILD2 RESULT_BUILD1 RESULT_BUILD2
+declare -a TIME_BUILD0 TIME_BUILD1 TIME_BUILD2 RESULT_BUILD0 RESULT_BUILD1 RESULT_BUILD2
 
 # Parsed options
 DO_DOWNLOAD=true
 DO_BUILD1=true
 DO_BUILD2=true
+DO_STOCK=false
+DO_REPORT=false
 ONLY_PKG=""
+COLLECT_STATS=false
+JOBS=$(( NCPU / 2 > 1 ? NCPU / 2 : 2 ))
+PARALLEL_MULTILIB=true
 
 # --- Helper functions ---
 
@@ -86,6 +124,11 @@ parse_args() {
             --download) DO_DOWNLOAD=true ;;
             --build1)   DO_DOWNLOAD=true; DO_BUILD1=true ;;
             --build2)   DO_DOWNLOAD=true; DO_BUILD2=true ;;
+            --stats)    COLLECT_STATS=true ;;
+            --stock)    DO_STOCK=true ;;
+            --report)   DO_REPORT=true ;;
+            --jobs=*)   JOBS="${arg#--jobs=}" ;;
+            --serial)   JOBS=1; PARALLEL_MULTILIB=false ;;
             --only=*)
                 ONLY_PKG="${arg#--only=}"
                 local found=false
@@ -96,16 +139,26 @@ parse_args() {
                     die "Unknown package '$ONLY_PKG'. Available: ${PKG_NAMES[*]}"
                 fi
                 ;;
-            *) die "Unknown argument: $arg (use --download, --build1, --build2, --only=<pkg>)" ;;
+            *) die "Unknown argument: $arg (use --download, --build1, --build2, --only=<pkg>, --stats, --stock, --report, --jobs=N, --serial)" ;;
         esac
     done
+    case "$JOBS" in
+        ''|*[!0-9]*|0) die "--jobs needs a positive number" ;;
+    esac
+    # Modifiers on their own (--stats, --stock, --report, --jobs, --serial,
+    # --only) mean a full build
+    if ! $DO_DOWNLOAD && ! $DO_BUILD1 && ! $DO_BUILD2; then
+        DO_DOWNLOAD=true; DO_BUILD1=true; DO_BUILD2=true
+    fi
+    if $DO_STOCK; then DO_DOWNLOAD=true; fi
 }
 
 # Create wrapper directories with gcc wrapper + binutils symlinks
 setup_wrappers() {
     local binutils_tools="ar ranlib ld as strip nm objcopy objdump readelf c++filt size strings"
 
-    for dir_pair in "bin1:build/build-host" "bin2:build/build-host-sjlj"; do
+    # bin0 is the stock compiler (--stock), for the size/cycle report
+    for dir_pair in "bin0:" "bin1:build/build-host" "bin2:build/build-host-sjlj"; do
         local bindir="${dir_pair%%:*}"
         local builddir="${dir_pair##*:}"
         local wrapdir="$WORK_DIR/$bindir"
@@ -113,19 +166,32 @@ setup_wrappers() {
 
         mkdir -p "$wrapdir"
 
-        # GCC wrapper script
-        cat > "$wrapdir/${TOOL_PREFIX}-gcc" <<WRAPPER
+        # GCC/G++ wrapper scripts. With MIKROS_STATS_DIR set (--stats), each
+        # compilation writes its pass counters to <dir>/<source>.<pid>.statistics.
+        # With MIKROS_KEEP_ASM set (--report), C/C++ compilations keep their
+        # assembly next to the object (foo.o -> foo.s).
+        for driver in gcc:xgcc g++:xg++; do
+            local exec_line="exec \"$gcc_build/${driver##*:}\" -B\"$gcc_build/\" -fchecking=2"
+            if [ -z "$builddir" ]; then
+                exec_line="exec \"/opt/cross-mint/bin/${TOOL_PREFIX}-${driver%%:*}\""
+            fi
+            cat > "$wrapdir/${TOOL_PREFIX}-${driver%%:*}" <<WRAPPER
 #!/bin/bash
-exec "$gcc_build/xgcc" -B"$gcc_build/" -fchecking=2 "\$@"
-WRAPPER
-        chmod +x "$wrapdir/${TOOL_PREFIX}-gcc"
-
-        # G++ wrapper script
-        cat > "$wrapdir/${TOOL_PREFIX}-g++" <<WRAPPER
-#!/bin/bash
-exec "$gcc_build/xg++" -B"$gcc_build/" -fchecking=2 "\$@"
+stats=()
+asm=()
+for a in "\$@"; do
+    case "\$a" in *.c|*.cc|*.cpp|*.cxx) src=\$(basename "\$a") ;; -c) compile=1 ;; esac
+done
+if [ -n "\$MIKROS_STATS_DIR" ] && [ -n "\$src" ]; then
+    stats=(-fdump-statistics="\$MIKROS_STATS_DIR/\$src.\$\$.statistics")
+fi
+if [ -n "\$MIKROS_KEEP_ASM" ] && [ -n "\$src" ] && [ -n "\$compile" ]; then
+    asm=(-save-temps=obj)
+fi
+$exec_line "\${stats[@]}" "\${asm[@]}" "\$@"
 WRAPPER
-        chmod +x "$wrapdir/${TOOL_PREFIX}-g++"
+            chmod +x "$wrapdir/${TOOL_PREFIX}-${driver%%:*}"
+        done
 
         # Symlinks for binutils
         for tool in $binutils_tools; do
@@ -197,9 +263,22 @@ download_all() {
     echo
 }
 
-# Extract all sources and apply patches
+# Per-compiler directories: compiler_dirs <BUILD1|BUILD2>
+# Sets BIN_DIR, BUILD_DIR, LOG_DIR, STATS_DIR and LABEL. Each compiler gets its
+# own source tree, so both can build at the same time.
+compiler_dirs() {
+    case "$1" in
+        BUILD0) BIN_DIR="$WORK_DIR/bin0"; LABEL="stock";    BUILD_DIR="$WORK_DIR/build-stock" ;;
+        BUILD1) BIN_DIR="$WORK_DIR/bin1"; LABEL="non-sjlj"; BUILD_DIR="$WORK_DIR/build-non-sjlj" ;;
+        BUILD2) BIN_DIR="$WORK_DIR/bin2"; LABEL="sjlj";     BUILD_DIR="$WORK_DIR/build-sjlj" ;;
+    esac
+    LOG_DIR="$WORK_DIR/logs-$LABEL"
+    STATS_DIR="$WORK_DIR/stats-$LABEL"
+}
+
+# Extract all sources into $BUILD_DIR and apply patches
 clean_build() {
-    local builddir="$WORK_DIR/build"
+    local builddir="$BUILD_DIR"
     rm -rf "$builddir"
     mkdir -p "$builddir"
     cd "$builddir"
@@ -230,96 +309,110 @@ clean_build() {
     cp "$SCRIPTS_DIR/freemint-m68k-atari-mintelf.cmake" "$builddir/"
 }
 
+# Build one package in the background-job subshell; the scheduler picks up
+# "<result> <seconds>" from $LOG_DIR/<name>.result
 build_package() {
-    local idx=$1 name=$2 func=$3 compiler=$4
-    printf "  [%2d/%d] %-16s " "$idx" "$PKG_COUNT" "$name"
+    local name=$1 func=$2
     local logfile="$LOG_DIR/${name}.log"
-    local start elapsed
+    local start elapsed result
+    if $COLLECT_STATS; then
+        export MIKROS_STATS_DIR="$STATS_DIR/$name"
+        mkdir -p "$MIKROS_STATS_DIR"
+    fi
     start=$(date +%s)
     if $func >> "$logfile" 2>&1; then
-        elapsed=$(($(date +%s) - start))
-        printf "PASS  %s\n" "$(format_time $elapsed)"
-        eval "RESULT_${compiler}[$idx]=PASS"
+        result=PASS
+    elif grep -q "internal compiler error" "$logfile" 2>/dev/null; then
+        result=FAIL-ICE
     else
-        elapsed=$(($(date +%s) - start))
-        if grep -q "internal compiler error" "$logfile" 2>/dev/null; then
-            printf "FAIL-ICE  %s\n" "$(format_time $elapsed)"
-            eval "RESULT_${compiler}[$idx]=FAIL-ICE"
-        else
-            printf "FAIL  %s\n" "$(format_time $elapsed)"
-            eval "RESULT_${compiler}[$idx]=FAIL"
-        fi
+        result=FAIL
     fi
-    eval "TIME_${compiler}[$idx]=\$elapsed"
+    elapsed=$(($(date +%s) - start))
+    echo "$result $elapsed" > "$LOG_DIR/${name}.result.tmp"
+    mv "$LOG_DIR/${name}.result.tmp" "$LOG_DIR/${name}.result"
 }
 
-# --- Multilib helper: build autoconf package for 3 targets ---
-# Usage: build_autoconf_3 <srcdir> <configure_args> [extra_env_per_target]
-build_autoconf_3() {
-    local srcdir="$1"; shift
-    local configure_args="$*"
-    cd "$WORK_DIR/build/$srcdir"
+# --- Multilib helper: build a package for all 3 targets ---
+# Usage: build_multilib <srcdir> <target_func> [args...]
+# Each target builds in its own copy of <srcdir> (<srcdir>-<multilib>), so the
+# targets run concurrently unless --serial is given. <target_func> is called
+# inside the copy as: <target_func> <cpu_flags> <lib_suffix> [args...]
+build_multilib() {
+    local srcdir="$1" func="$2"; shift 2
+    local ml name cpu lib status=0
+    local pids=()
+
+    for ml in "${MULTILIBS[@]}"; do
+        name="${ml%%:*}"
+        rm -rf "${BUILD_DIR:?}/$srcdir-$name"
+        cp -Rp "$BUILD_DIR/$srcdir" "$BUILD_DIR/$srcdir-$name"
+    done
 
-    # m68000
-    CFLAGS='-O2 -fomit-frame-pointer -m68000' \
-        ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib --bindir=${SYSROOT}/usr/bin \
-        $configure_args
-    make
-    make distclean
+    for ml in "${MULTILIBS[@]}"; do
+        IFS=: read -r name cpu lib <<< "$ml"
+        if $PARALLEL_MULTILIB; then
+            (cd "$BUILD_DIR/$srcdir-$name" && $func "$cpu" "$lib" "$@") > "$BUILD_DIR/$srcdir-$name.log" 2>&1 &
+            pids+=($!)
+        else
+            (cd "$BUILD_DIR/$srcdir-$name" && $func "$cpu" "$lib" "$@") > "$BUILD_DIR/$srcdir-$name.log" 2>&1 || status=1
+        fi
+    done
+    for pid in "${pids[@]}"; do
+        wait "$pid" || status=1
+    done
 
-    # m68020-60
-    CFLAGS='-O2 -fomit-frame-pointer -m68020-60' \
-        ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib/m68020-60 --bindir=${SYSROOT}/usr/bin/m68020-60 \
-        $configure_args
-    make
-    make distclean
+    # Keep the package log readable: one target after the other
+    for ml in "${MULTILIBS[@]}"; do
+        name="${ml%%:*}"
+        echo "=== $srcdir ($name) ==="
+        cat "$BUILD_DIR/$srcdir-$name.log"
+    done
+    return $status
+}
 
-    # ColdFire m5475
-    CFLAGS='-O2 -fomit-frame-pointer -mcpu=5475' \
+# Generic autoconf target: autoconf_target <cpu_flags> <lib_suffix> <configure_args>
+autoconf_target() {
+    local cpu="$1" lib="$2"; shift 2
+    CFLAGS="-O2 -fomit-frame-pointer $cpu" \
         ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib/m5475 --bindir=${SYSROOT}/usr/bin/m5475 \
-        $configure_args
+        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib$lib --bindir=${SYSROOT}/usr/bin$lib \
+        $*
     make
 }
 
-# --- 16 package build functions ---
-
-build_zlib() {
-    cd "$WORK_DIR/build/zlib-${ZLIB_VERSION}"
+build_autoconf_3() {
+    local srcdir="$1"; shift
+    build_multilib "$srcdir" autoconf_target "$*"
+}
 
-    # m68000
-    CFLAGS='-O2 -fomit-frame-pointer -m68000' \
-        CC=${TOOL_PREFIX}-gcc AR=${TOOL_PREFIX}-ar RANLIB=${TOOL_PREFIX}-ranlib \
-        ./configure --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib
-    make AR="${TOOL_PREFIX}-ar" ARFLAGS=rcs RANLIB="${TOOL_PREFIX}-ranlib"
-    make distclean
+# --- 16 package build functions ---
 
-    # m68020-60
-    CFLAGS='-O2 -fomit-frame-pointer -m68020-60' \
+zlib_target() {
+    local cpu="$1" lib="$2"
+    CFLAGS="-O2 -fomit-frame-pointer $cpu" \
         CC=${TOOL_PREFIX}-gcc AR=${TOOL_PREFIX}-ar RANLIB=${TOOL_PREFIX}-ranlib \
-        ./configure --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib/m68020-60
+        ./configure --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib$lib
     make AR="${TOOL_PREFIX}-ar" ARFLAGS=rcs RANLIB="${TOOL_PREFIX}-ranlib"
-    make distclean
+}
 
-    # ColdFire m5475
-    CFLAGS='-O2 -fomit-frame-pointer -mcpu=5475' \
-        CC=${TOOL_PREFIX}-gcc AR=${TOOL_PREFIX}-ar RANLIB=${TOOL_PREFIX}-ranlib \
-        ./configure --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib/m5475
-    make AR="${TOOL_PREFIX}-ar" ARFLAGS=rcs RANLIB="${TOOL_PREFIX}-ranlib"
+build_zlib() {
+    build_multilib "zlib-${ZLIB_VERSION}" zlib_target
 }
 
 build_gemlib() {
-    cd "$WORK_DIR/build/gemlib-${GEMLIB_VERSION}"
+    cd "$BUILD_DIR/gemlib-${GEMLIB_VERSION}"
     make CROSS_TOOL=${TOOL_PREFIX} DESTDIR=${SYSROOT} PREFIX=/usr V=1
 }
 
+ldg_target() {
+    local lib="$2" makefile=gcc.mak
+    [ -n "$lib" ] && makefile="gcc${lib#/}.mak"
+    cd src/devel
+    make -f "$makefile" CC=${TOOL_PREFIX}-gcc AR=${TOOL_PREFIX}-ar
+}
+
 build_ldg() {
-    cd "$WORK_DIR/build/ldg-trunk/src/devel"
-    make -f gcc.mak CC=${TOOL_PREFIX}-gcc AR=${TOOL_PREFIX}-ar
-    make -f gccm68020-60.mak CC=${TOOL_PREFIX}-gcc AR=${TOOL_PREFIX}-ar
-    make -f gccm5475.mak CC=${TOOL_PREFIX}-gcc AR=${TOOL_PREFIX}-ar
+    build_multilib ldg-trunk ldg_target
 }
 
 build_sdl() {
@@ -334,103 +427,67 @@ build_libxmp_lite() {
     build_autoconf_3 "libxmp-lite-${LIBXMP_LITE_VERSION}" "--disable-it"
 }
 
-build_physfs() {
-    cd "$WORK_DIR/build/physfs-${PHYSFS_VERSION}"
-
-    # m68000
+physfs_target() {
+    local cpu="$1" lib="$2" cflags="-fomit-frame-pointer"
+    # m68000 is the toolchain default and was always built without a CPU flag
+    [ -n "$lib" ] && cflags="$cflags $cpu"
     mkdir -p build && cd build
-    cmake -DCMAKE_TOOLCHAIN_FILE="$WORK_DIR/build/freemint-m68k-atari-mintelf.cmake" \
-        -DCMAKE_BUILD_TYPE=Release -DCMAKE_C_FLAGS="-fomit-frame-pointer" \
+    cmake -DCMAKE_TOOLCHAIN_FILE="$BUILD_DIR/freemint-m68k-atari-mintelf.cmake" \
+        -DCMAKE_BUILD_TYPE=Release -DCMAKE_C_FLAGS="$cflags" \
         -DPHYSFS_BUILD_SHARED=0 \
-        -DCMAKE_INSTALL_PREFIX=${SYSROOT}/usr -DCMAKE_INSTALL_LIBDIR=lib -DCMAKE_INSTALL_BINDIR=bin ..
+        -DCMAKE_INSTALL_PREFIX=${SYSROOT}/usr -DCMAKE_INSTALL_LIBDIR=lib$lib -DCMAKE_INSTALL_BINDIR=bin$lib ..
     make VERBOSE=1
-    cd ..
-
-    # m68020-60
-    mkdir -p build020 && cd build020
-    cmake -DCMAKE_TOOLCHAIN_FILE="$WORK_DIR/build/freemint-m68k-atari-mintelf.cmake" \
-        -DCMAKE_BUILD_TYPE=Release -DCMAKE_C_FLAGS="-fomit-frame-pointer -m68020-60" \
-        -DPHYSFS_BUILD_SHARED=0 \
-        -DCMAKE_INSTALL_PREFIX=${SYSROOT}/usr -DCMAKE_INSTALL_LIBDIR=lib/m68020-60 -DCMAKE_INSTALL_BINDIR=bin/m68020-60 ..
-    make VERBOSE=1
-    cd ..
+}
 
-    # ColdFire m5475
-    mkdir -p buildcf && cd buildcf
-    cmake -DCMAKE_TOOLCHAIN_FILE="$WORK_DIR/build/freemint-m68k-atari-mintelf.cmake" \
-        -DCMAKE_BUILD_TYPE=Release -DCMAKE_C_FLAGS="-fomit-frame-pointer -mcpu=5475" \
-        -DPHYSFS_BUILD_SHARED=0 \
-        -DCMAKE_INSTALL_PREFIX=${SYSROOT}/usr -DCMAKE_INSTALL_LIBDIR=lib/m5475 -DCMAKE_INSTALL_BINDIR=bin/m5475 ..
-    make VERBOSE=1
-    cd ..
+build_physfs() {
+    build_multilib "physfs-${PHYSFS_VERSION}" physfs_target
 }
 
 build_cflib() {
-    cd "$WORK_DIR/build/cflib-${CFLIB_VERSION}"
+    cd "$BUILD_DIR/cflib-${CFLIB_VERSION}"
     make CROSS_TOOL=${TOOL_PREFIX} DESTDIR=${SYSROOT} PREFIX=/usr V=1
 }
 
 build_libcmini() {
-    cd "$WORK_DIR/build/libcmini-${LIBCMINI_VERSION}"
+    cd "$BUILD_DIR/libcmini-${LIBCMINI_VERSION}"
     make PREFIX=${SYSROOT}/opt/libcmini BUILD_FAST=N BUILD_SOFT_FLOAT=N COMPILE_ELF=Y VERBOSE=yes
 }
 
 build_mintlib() {
-    cd "$WORK_DIR/build/mintlib-${MINTLIB_VERSION}"
+    cd "$BUILD_DIR/mintlib-${MINTLIB_VERSION}"
     make CROSS=yes CROSS_TOOL=${TOOL_PREFIX} prefix=${SYSROOT}/usr
 }
 
-build_asap() {
-    cd "$WORK_DIR/build/asap-${ASAP_VERSION}"
-
-    # m68000
+asap_target() {
+    local cpu="$1" lib="$2"
     make CC=${TOOL_PREFIX}-gcc AR=${TOOL_PREFIX}-ar \
-        CFLAGS='-O2 -fomit-frame-pointer -m68000' \
-        prefix=${SYSROOT}/usr libdir=${SYSROOT}/usr/lib bindir=${SYSROOT}/usr/bin
-    rm -f asap.o libasap.a asapconv
-
-    # m68020-60
-    make CC=${TOOL_PREFIX}-gcc AR=${TOOL_PREFIX}-ar \
-        CFLAGS='-O2 -fomit-frame-pointer -m68020-60' \
-        prefix=${SYSROOT}/usr libdir=${SYSROOT}/usr/lib/m68020-60 bindir=${SYSROOT}/usr/bin/m68020-60
-    rm -f asap.o libasap.a asapconv
+        CFLAGS="-O2 -fomit-frame-pointer $cpu" \
+        prefix=${SYSROOT}/usr libdir=${SYSROOT}/usr/lib$lib bindir=${SYSROOT}/usr/bin$lib
+}
 
-    # ColdFire m5475
-    make CC=${TOOL_PREFIX}-gcc AR=${TOOL_PREFIX}-ar \
-        CFLAGS='-O2 -fomit-frame-pointer -mcpu=5475' \
-        prefix=${SYSROOT}/usr libdir=${SYSROOT}/usr/lib/m5475 bindir=${SYSROOT}/usr/bin/m5475
+build_asap() {
+    build_multilib "asap-${ASAP_VERSION}" asap_target
 }
 
-build_mpg123() {
-    cd "$WORK_DIR/build/mpg123-${MPG123_VERSION}"
+mpg123_target() {
+    local cpu="$1" lib="$2" fpu=generic_fpu
     local common_args="--disable-components --enable-libmpg123 --enable-network=no --disable-gapless --disable-feeder --disable-new-huffman --disable-messages --disable-equalizer --disable-32bit --disable-real --disable-feature_report --disable-largefile --with-seektable=0"
 
-    # m68000 (no FPU)
-    CFLAGS='-O2 -fomit-frame-pointer -m68000' \
+    # m68000 has no FPU
+    [ -z "$lib" ] && fpu=generic_nofpu
+    CFLAGS="-O2 -fomit-frame-pointer $cpu" \
         ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib \
-        --with-cpu=generic_nofpu $common_args
+        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib$lib \
+        --with-cpu=$fpu $common_args
     make
-    make distclean
-
-    # m68020-60 (FPU)
-    CFLAGS='-O2 -fomit-frame-pointer -m68020-60' \
-        ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib/m68020-60 \
-        --with-cpu=generic_fpu $common_args
-    make
-    make distclean
+}
 
-    # ColdFire m5475 (FPU)
-    CFLAGS='-O2 -fomit-frame-pointer -mcpu=5475' \
-        ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib/m5475 \
-        --with-cpu=generic_fpu $common_args
-    make
+build_mpg123() {
+    build_multilib "mpg123-${MPG123_VERSION}" mpg123_target
 }
 
 build_uthread() {
-    cd "$WORK_DIR/build/uthread-${UTHREAD_VERSION}"
+    cd "$BUILD_DIR/uthread-${UTHREAD_VERSION}"
     # 'make release' calls install internally; just build the library
     make CPU_FLG=-m68020-60
 }
@@ -444,129 +501,176 @@ build_usound() {
     test -f "$DOWNLOAD_DIR/usound.h"
 }
 
-build_sdl_image() {
-    cd "$WORK_DIR/build/SDL_image-${SDL_IMAGE_VERSION}"
-
-    # m68000
-    PKG_CONFIG_LIBDIR=${SYSROOT}/usr/lib/pkgconfig \
-        CFLAGS='-O2 -fomit-frame-pointer -m68000' \
+sdl_image_target() {
+    local cpu="$1" lib="$2"
+    PKG_CONFIG_LIBDIR=${SYSROOT}/usr/lib$lib/pkgconfig \
+        CFLAGS="-O2 -fomit-frame-pointer $cpu" \
         ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib --bindir=${SYSROOT}/usr/bin
+        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib$lib --bindir=${SYSROOT}/usr/bin$lib
     make
-    make distclean
+}
 
-    # m68020-60
-    PKG_CONFIG_LIBDIR=${SYSROOT}/usr/lib/m68020-60/pkgconfig \
-        CFLAGS='-O2 -fomit-frame-pointer -m68020-60' \
-        ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib/m68020-60 --bindir=${SYSROOT}/usr/bin/m68020-60
-    make
-    make distclean
+build_sdl_image() {
+    build_multilib "SDL_image-${SDL_IMAGE_VERSION}" sdl_image_target
+}
 
-    # ColdFire m5475
-    PKG_CONFIG_LIBDIR=${SYSROOT}/usr/lib/m5475/pkgconfig \
-        CFLAGS='-O2 -fomit-frame-pointer -mcpu=5475' \
+sdl_mixer_target() {
+    local cpu="$1" lib="$2"
+    local disable_args="--disable-music-mod --disable-music-timidity-midi --disable-music-fluidsynth-midi --disable-music-ogg --disable-music-flac --disable-music-mp3"
+    PKG_CONFIG_LIBDIR=${SYSROOT}/usr/lib$lib/pkgconfig \
+        CFLAGS="-O2 -fomit-frame-pointer $cpu" LDFLAGS="$cpu" \
         ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib/m5475 --bindir=${SYSROOT}/usr/bin/m5475
+        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib$lib --bindir=${SYSROOT}/usr/bin$lib \
+        $disable_args
     make
 }
 
 build_sdl_mixer() {
-    cd "$WORK_DIR/build/SDL_mixer-1.2-${SDL_MIXER_VERSION}"
-    local disable_args="--disable-music-mod --disable-music-timidity-midi --disable-music-fluidsynth-midi --disable-music-ogg --disable-music-flac --disable-music-mp3"
+    build_multilib "SDL_mixer-1.2-${SDL_MIXER_VERSION}" sdl_mixer_target
+}
 
-    # m68000
-    PKG_CONFIG_LIBDIR=${SYSROOT}/usr/lib/pkgconfig \
-        CFLAGS='-O2 -fomit-frame-pointer -m68000' LDFLAGS='-m68000' \
-        ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib --bindir=${SYSROOT}/usr/bin \
-        $disable_args
-    make
-    make distclean
+# --- Scheduler: build packages for one or both compilers ---
 
-    # m68020-60
-    PKG_CONFIG_LIBDIR=${SYSROOT}/usr/lib/m68020-60/pkgconfig \
-        CFLAGS='-O2 -fomit-frame-pointer -m68020-60' LDFLAGS='-m68020-60' \
-        ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib/m68020-60 --bindir=${SYSROOT}/usr/bin/m68020-60 \
-        $disable_args
-    make
-    make distclean
+PKG_FUNCS=(
+    build_zlib build_gemlib build_ldg build_sdl
+    build_libxmp build_libxmp_lite build_physfs build_cflib
+    build_libcmini build_mintlib build_asap build_mpg123 build_uthread
+    build_libpng build_usound build_sdl_image build_sdl_mixer
+)
 
-    # ColdFire m5475
-    PKG_CONFIG_LIBDIR=${SYSROOT}/usr/lib/m5475/pkgconfig \
-        CFLAGS='-O2 -fomit-frame-pointer -mcpu=5475' LDFLAGS='-mcpu=5475' \
-        ./configure --host=${TOOL_PREFIX} \
-        --prefix=${SYSROOT}/usr --libdir=${SYSROOT}/usr/lib/m5475 --bindir=${SYSROOT}/usr/bin/m5475 \
-        $disable_args
-    make
+pkg_index() {
+    local i
+    for i in $(seq 0 $((PKG_COUNT - 1))); do
+        if [ "${PKG_NAMES[$i]}" = "$1" ]; then echo "$i"; return; fi
+    done
 }
 
-# --- Build all packages for one compiler ---
+# True when every dependency of package <idx> has finished for <compiler>.
+# Dependencies outside --only are not built, so they count as finished.
+deps_done() {
+    local compiler=$1 idx=$2 dep
+    compiler_dirs "$compiler"
+    for dep in ${PKG_DEPS[$idx]}; do
+        if [ -n "$ONLY_PKG" ] && [ "$dep" != "$ONLY_PKG" ]; then continue; fi
+        [ -f "$LOG_DIR/$dep.result" ] || return 1
+    done
+}
 
+start_job() {
+    local compiler=$1 idx=$2
+    (
+        compiler_dirs "$compiler"
+        export PATH="$BIN_DIR:$PATH"
+        build_package "${PKG_NAMES[$idx]}" "${PKG_FUNCS[$idx]}"
+    ) &
+}
+
+# Report a finished job and record its result; returns 1 if still running
+reap_job() {
+    local compiler=$1 idx=$2 result elapsed
+    compiler_dirs "$compiler"
+    [ -f "$LOG_DIR/${PKG_NAMES[$idx]}.result" ] || return 1
+    read -r result elapsed < "$LOG_DIR/${PKG_NAMES[$idx]}.result"
+    printf "  [%2d/%d] %-16s %-9s %-9s %s\n" $((idx + 1)) "$PKG_COUNT" "${PKG_NAMES[$idx]}" \
+        "$LABEL" "$result" "$(format_time "$elapsed")"
+    eval "RESULT_${compiler}[$((idx + 1))]=$result"
+    eval "TIME_${compiler}[$((idx + 1))]=$elapsed"
+}
+
+# Usage: build_all <compiler>...
+# Runs up to $JOBS package builds at once. A package starts once its
+# PKG_DEPS have finished for the same compiler; packages are queued in
+# PKG_NAMES order with the compilers interleaved.
 build_all() {
-    local compiler=$1
-    local funcs=(
-        build_zlib build_gemlib build_ldg build_sdl
-        build_libxmp build_libxmp_lite build_physfs build_cflib
-        build_libcmini build_mintlib build_asap build_mpg123 build_uthread
-        build_libpng build_usound build_sdl_image build_sdl_mixer
-    )
+    local compilers=("$@")
+    local pending=() running=() job next i c
+
+    for c in "${compilers[@]}"; do
+        compiler_dirs "$c"
+        mkdir -p "$LOG_DIR"
+        (clean_build > "$LOG_DIR/extract.log" 2>&1) &
+    done
+    wait
 
     for i in $(seq 0 $((PKG_COUNT - 1))); do
         if [ -n "$ONLY_PKG" ] && [ "${PKG_NAMES[$i]}" != "$ONLY_PKG" ]; then
             continue
         fi
-        build_package $((i + 1)) "${PKG_NAMES[$i]}" "${funcs[$i]}" "$compiler"
+        for c in "${compilers[@]}"; do
+            pending+=("$c:$i")
+        done
     done
+
+    while [ ${#pending[@]} -gt 0 ] || [ ${#running[@]} -gt 0 ]; do
+        next=()
+        for job in "${running[@]}"; do
+            reap_job "${job%%:*}" "${job##*:}" || next+=("$job")
+        done
+        running=("${next[@]}")
+
+        next=()
+        for job in "${pending[@]}"; do
+            if [ ${#running[@]} -lt "$JOBS" ] && deps_done "${job%%:*}" "${job##*:}"; then
+                start_job "${job%%:*}" "${job##*:}"
+                running+=("$job")
+            else
+                next+=("$job")
+            fi
+        done
+        pending=("${next[@]}")
+
+        if [ ${#running[@]} -eq 0 ] && [ ${#pending[@]} -gt 0 ]; then
+            die "Unsatisfiable PKG_DEPS for: ${pending[*]}"
+        fi
+        [ ${#running[@]} -gt 0 ] && sleep 1
+    done
+    wait
 }
 
 # --- Print results table ---
 
 print_results() {
-    local has_build1=$1 has_build2=$2
-
-    echo "==================================================================="
-    echo "                        Build Results"
-    echo "==================================================================="
-
-    if $has_build1 && $has_build2; then
-        printf " %-16s %-10s %10s   %-10s %10s\n" "Package" "non-sjlj" "(build)" "sjlj" "(sjlj)"
-        echo "-------------------------------------------------------------------"
-        local pass1=0 pass2=0 total1=0 total2=0
-        for i in $(seq 1 $PKG_COUNT); do
-            local r1="${RESULT_BUILD1[$i]:-N/A}"
-            local r2="${RESULT_BUILD2[$i]:-N/A}"
-            local t1="${TIME_BUILD1[$i]:-0}"
-            local t2="${TIME_BUILD2[$i]:-0}"
-            printf " %-16s %-10s %10s   %-10s %10s\n" \
-                "${PKG_NAMES[$((i-1))]}" "$r1" "$(format_time $t1)" "$r2" "$(format_time $t2)"
-            [[ "$r1" == "PASS" ]] && pass1=$((pass1 + 1))
-            [[ "$r2" == "PASS" ]] && pass2=$((pass2 + 1))
-            total1=$((total1 + t1))
-            total2=$((total2 + t2))
-        done
-        echo "-------------------------------------------------------------------"
-        printf " %-16s %-10s %10s   %-10s %10s\n" \
-            "TOTAL" "${pass1}/${PKG_COUNT}" "$(format_time $total1)" "${pass2}/${PKG_COUNT}" "$(format_time $total2)"
-    else
-        local label compiler_var
-        if $has_build1; then label="non-sjlj (build)"; compiler_var="BUILD1";
-        else label="sjlj"; compiler_var="BUILD2"; fi
-        printf " %-16s %-10s %10s\n" "Package" "$label" ""
-        echo "-------------------------------------------------------------------"
-        local pass=0 total=0
-        for i in $(seq 1 $PKG_COUNT); do
-            local r; eval "r=\${RESULT_${compiler_var}[$i]:-N/A}"
-            local t; eval "t=\${TIME_${compiler_var}[$i]:-0}"
-            printf " %-16s %-10s %10s\n" "${PKG_NAMES[$((i-1))]}" "$r" "$(format_time $t)"
-            [[ "$r" == "PASS" ]] && pass=$((pass + 1))
-            total=$((total + t))
+    local compilers=("$@")
+    local c i r t label width=17
+    local rule
+
+    for c in "${compilers[@]}"; do width=$((width + 24)); done
+    [ $width -lt 67 ] && width=67
+    rule=$(printf "%${width}s" "" | tr ' ' '-')
+
+    echo "${rule//-/=}"
+    printf "%$(( (width + 13) / 2 ))s\n" "Build Results"
+    echo "${rule//-/=}"
+
+    printf " %-16s" "Package"
+    for c in "${compilers[@]}"; do
+        compiler_dirs "$c"
+        label="$LABEL"
+        [ "$c" = BUILD1 ] && label="non-sjlj (build)"
+        printf " %-16s %6s " "$label" ""
+    done
+    echo
+    echo "$rule"
+    for i in $(seq 1 $PKG_COUNT); do
+        printf " %-16s" "${PKG_NAMES[$((i-1))]}"
+        for c in "${compilers[@]}"; do
+            eval "r=\${RESULT_${c}[$i]:-N/A}"
+            eval "t=\${TIME_${c}[$i]:-0}"
+            printf " %-10s %12s " "$r" "$(format_time $t)"
+            [[ "$r" == "PASS" ]] && eval "PASS_${c}=\$((\${PASS_${c}:-0} + 1))"
+            eval "TOTAL_${c}=\$((\${TOTAL_${c}:-0} + t))"
         done
-        echo "-------------------------------------------------------------------"
-        printf " %-16s %-10s %10s\n" "TOTAL" "${pass}/${PKG_COUNT}" "$(format_time $total)"
-    fi
-    echo "==================================================================="
+        echo
+    done
+    echo "$rule"
+    printf " %-16s" "TOTAL"
+    for c in "${compilers[@]}"; do
+        eval "r=\${PASS_${c}:-0}"
+        eval "t=\${TOTAL_${c}:-0}"
+        printf " %-10s %12s " "${r}/${PKG_COUNT}" "$(format_time $t)"
+    done
+    echo
+    echo "${rule//-/=}"
 }
 
 # --- Main ---
@@ -580,7 +684,12 @@ echo
 
 mkdir -p "$WORK_DIR"
 
-if $DO_BUILD1 || $DO_BUILD2; then
+BUILDING=false
+if $DO_STOCK || $DO_BUILD1 || $DO_BUILD2; then
+    BUILDING=true
+fi
+
+if $BUILDING; then
     setup_wrappers
 fi
 
@@ -588,32 +697,41 @@ if $DO_DOWNLOAD; then
     download_all
 fi
 
-if $DO_BUILD1; then
-    echo "=== Building with non-sjlj compiler (build) ==="
-    export PATH="$WORK_DIR/bin1:$PATH"
-    LOG_DIR="$WORK_DIR/logs-non-sjlj"
-    mkdir -p "$LOG_DIR"
-    clean_build
-    build_all BUILD1
-    # Restore PATH (remove our bin1 prefix)
-    export PATH="${PATH#$WORK_DIR/bin1:}"
+if $BUILDING; then
+    compilers=()
+    labels=()
+    $DO_STOCK && compilers+=(BUILD0) && labels+=(stock)
+    $DO_BUILD1 && compilers+=(BUILD1) && labels+=("non-sjlj (build)")
+    $DO_BUILD2 && compilers+=(BUILD2) && labels+=(sjlj)
+    if [ ${#labels[@]} -eq 1 ]; then
+        echo "=== Building with ${labels[0]} compiler, $JOBS jobs ==="
+    else
+        last=$((${#labels[@]} - 1))
+        list=$(printf ", %s" "${labels[@]:0:$last}")
+        echo "=== Building with ${list#, } and ${labels[$last]} compilers, $JOBS jobs ==="
+    fi
+    if $DO_REPORT; then
+        export MIKROS_KEEP_ASM=1
+    fi
+    trap 'kill $(jobs -p) 2>/dev/null; exit 130' INT TERM
+    wall_start=$(date +%s)
+    build_all "${compilers[@]}"
+    wall_time=$(($(date +%s) - wall_start))
     echo
 fi
 
-if $DO_BUILD2; then
-    echo "=== Building with sjlj compiler ==="
-    export PATH="$WORK_DIR/bin2:$PATH"
-    LOG_DIR="$WORK_DIR/logs-sjlj"
-    mkdir -p "$LOG_DIR"
-    clean_build
-    build_all BUILD2
-    export PATH="${PATH#$WORK_DIR/bin2:}"
+if $BUILDING; then
     echo
+    print_results "${compilers[@]}"
+    echo "Wall time: $(format_time $wall_time) (TOTAL columns sum the package times)"
+    echo
+    echo "Log files: $WORK_DIR/logs-*/"
+    if $COLLECT_STATS; then
+        echo "Pass statistics: $WORK_DIR/stats-*/ (summarize with ./debug-pass-stats.sh <dir>)"
+    fi
 fi
 
-if $DO_BUILD1 || $DO_BUILD2; then
-    echo
-    print_results "$DO_BUILD1" "$DO_BUILD2"
+if $BUILDING && $DO_REPORT; then
     echo
-    echo "Log files: $WORK_DIR/logs-*/"
+    PATH="$WORK_DIR/bin0:$PATH" "$(dirname "$0")/debug-mikros-report.sh" "$WORK_DIR"
 fi
@@ -2,32 +2,60 @@
 # Generate assembly output for test_cases.cpp with various optimization options
 # Compares output between system compiler (old) and built compiler (new)
 #
-# Default: show max clock cycles per variant (requires clccnt)
+# Default: show max clock cycles per variant (requires clccnt; without it,
+#          68000 variants use debug-annotate-cycles.sh estimates)
 # -s: show instruction count (size) instead of cycles
 # -reload: include reload (legacy register allocator) comparison columns
+# -sjlj: also measure sjlj exception registration overhead (test_cases_sjlj.c)
+# -nocache: recompile everything instead of reusing cached .s files
+# -record: store per-function metrics with debug-perf-history.sh afterwards
+#
+# Variants compile in parallel (one job per CPU). Each .s is cached under
+# tmp/test_cases/cache, keyed by the compiler binaries, flags and source, so
+# only the compiler that changed is rerun.
 
 set -e
 
 # Parse options
 MODE="cycles"
 SHOW_RELOAD=false
+SHOW_SJLJ=false
+USE_CACHE=true
+RECORD=false
 for arg in "$@"; do
     case $arg in
         -s) MODE="size" ;;
         -reload) SHOW_RELOAD=true ;;
-        *) echo "Usage: $0 [-s] [-reload]"; exit 1 ;;
+        -sjlj) SHOW_SJLJ=true ;;
+        -nocache) USE_CACHE=false ;;
+        -record) RECORD=true ;;
+        *) echo "Usage: $0 [-s] [-reload] [-sjlj] [-nocache] [-record]"; exit 1 ;;
     esac
 done
 
-# Fall back to size mode if clccnt is not available
+# Fall back to the 68000 estimator, then size mode, if clccnt is not available
 CLCCNT=$(command -v clccnt 2>/dev/null || true)
+ANNOTATE="./debug-annotate-cycles.sh"
 if [ "$MODE" = "cycles" ] && [ -z "$CLCCNT" ]; then
-    MODE="size"
+    if [ -x "$ANNOTATE" ]; then
+        MODE="estimate"
+    else
+        MODE="size"
+    fi
 fi
 
 SOURCE="test_cases.cpp"
+SJLJ_SOURCE="test_cases_sjlj.c"
 OUTPUT_DIR="tmp/test_cases"
 REGR_LOG="$OUTPUT_DIR/regressed.log"
+SJLJ_LOG="$OUTPUT_DIR/sjlj_overhead.log"
+CACHE_DIR="$OUTPUT_DIR/cache"
+WORK_DIR="$OUTPUT_DIR/.jobs"
+JOBS=$(sysctl -n hw.ncpu 2>/dev/null || nproc 2>/dev/null || echo 4)
+
+CC_OLD="m68k-atari-mintelf-gcc"
+CC_NEW="./build-host/gcc/xgcc -B./build-host/gcc"
+CC_SJLJ="./build-host-sjlj/gcc/xgcc -B./build-host-sjlj/gcc"
 
 if [ ! -f "$SOURCE" ]; then
     echo "Error: $SOURCE not found"
@@ -35,7 +63,9 @@ if [ ! -f "$SOURCE" ]; then
 fi
 
 # Create output directory
-mkdir -p "$OUTPUT_DIR"
+mkdir -p "$OUTPUT_DIR" "$CACHE_DIR"
+rm -rf "$WORK_DIR"
+mkdir -p "$WORK_DIR/times" "$WORK_DIR/rows"
 
 # Clear regression log
 > "$REGR_LOG"
@@ -48,38 +78,85 @@ COMMON_FLAGS="-mfastcall"
 echo "Common flags: $COMMON_FLAGS"
 echo ""
 
-# Accumulated build times (in milliseconds for precision)
-time_old_ms=0
-time_new_ms=0
-time_reload_ms=0  # only used with -reload
+now_ms() {
+    perl -MTime::HiRes=time -e 'printf "%.0f", time()*1000'
+}
 
-# Function to generate assembly
+sha() {
+    if command -v sha256sum >/dev/null; then sha256sum; else shasum -a 256; fi | cut -c1-64
+}
+
+# Identity of a compiler: its driver plus the cc1/cc1plus it runs.
+# Empty when the compiler is missing; such jobs are never cached.
+compiler_hash() {
+    local cc="$1" prog="$2"
+    local driver proper
+    driver=$(command -v ${cc%% *} 2>/dev/null) || return 0
+    proper=$($cc -print-prog-name="$prog" 2>/dev/null) || return 0
+    [ -f "$proper" ] || proper=$(command -v "$proper" 2>/dev/null) || return 0
+    cat "$driver" "$proper" | sha
+}
+
+# Compile one .s, or copy it from the cache: compile_job <which> <flags> <source> <output>
+# Records "<which> <compiled|cached> <ms>" in $WORK_DIR/times/.
+compile_job() {
+    local which="$1" flags="$2" src="$3" out="$4"
+    local cc hash src_hash key t0 t1
+    case $which in
+        old)        cc="$CC_OLD";  hash="$HASH_OLD" ;;
+        new|reload) cc="$CC_NEW";  hash="$HASH_NEW" ;;
+        sjlj)       cc="$CC_SJLJ"; hash="$HASH_SJLJ" ;;
+    esac
+    if [ "$src" = "$SOURCE" ]; then src_hash="$SOURCE_HASH"; else src_hash="$SJLJ_SOURCE_HASH"; fi
+    key=$(printf '%s\n%s\n%s\n' "$hash" "$flags" "$src_hash" | sha)
+    local times="$WORK_DIR/times/$(basename "$out")"
+
+    rm -f "$out"
+    if $USE_CACHE && [ -n "$hash" ] && [ -f "$CACHE_DIR/$key.s" ]; then
+        cp "$CACHE_DIR/$key.s" "$out"
+        touch "$CACHE_DIR/$key.s"
+        echo "$which cached 0" > "$times"
+        return 0
+    fi
+
+    t0=$(now_ms)
+    # shellcheck disable=SC2086
+    if $cc $flags -S "$src" -o "$out" 2>/dev/null && [ -n "$hash" ]; then
+        cp "$out" "$CACHE_DIR/$key.s.$$" && mv -f "$CACHE_DIR/$key.s.$$" "$CACHE_DIR/$key.s"
+    fi
+    t1=$(now_ms)
+    echo "$which compiled $((t1 - t0))" > "$times"
+}
+
+# Queue a compile job (NUL-separated fields for xargs -0)
+queue() {
+    printf '%s\0' "$@" >> "$WORK_DIR/compile.jobs"
+}
+
+# Function to queue the assembly for one variant
 generate() {
     local suffix="$1"
     local flags="$2"
-    local t0 t1
 
-    # Old (system compiler)
-    t0=$(perl -MTime::HiRes=time -e 'printf "%.0f", time()*1000')
-    m68k-atari-mintelf-gcc $COMMON_FLAGS $flags -fno-inline -S "$SOURCE" -o "$OUTPUT_DIR/${suffix}_old.s" 2>/dev/null || true
-    t1=$(perl -MTime::HiRes=time -e 'printf "%.0f", time()*1000')
-    time_old_ms=$((time_old_ms + t1 - t0))
-
-    # New (built compiler, LRA is default)
-    t0=$(perl -MTime::HiRes=time -e 'printf "%.0f", time()*1000')
-    ./build-host/gcc/xgcc -B./build-host/gcc $COMMON_FLAGS $flags -fno-inline -S "$SOURCE" -o "$OUTPUT_DIR/${suffix}_new.s" 2>/dev/null || true
-    t1=$(perl -MTime::HiRes=time -e 'printf "%.0f", time()*1000')
-    time_new_ms=$((time_new_ms + t1 - t0))
+    # Old (system compiler), new (built compiler, LRA is default)
+    queue old "$COMMON_FLAGS $flags -fno-inline" "$SOURCE" "$OUTPUT_DIR/${suffix}_old.s"
+    queue new "$COMMON_FLAGS $flags -fno-inline" "$SOURCE" "$OUTPUT_DIR/${suffix}_new.s"
 
     # Reload (built compiler with legacy reload) - only with -reload
     if $SHOW_RELOAD; then
-        t0=$(perl -MTime::HiRes=time -e 'printf "%.0f", time()*1000')
-        ./build-host/gcc/xgcc -B./build-host/gcc $COMMON_FLAGS $flags -mno-lra -fno-inline -S "$SOURCE" -o "$OUTPUT_DIR/${suffix}_reload.s" 2>/dev/null || true
-        t1=$(perl -MTime::HiRes=time -e 'printf "%.0f", time()*1000')
-        time_reload_ms=$((time_reload_ms + t1 - t0))
+        queue reload "$COMMON_FLAGS $flags -mno-lra -fno-inline" "$SOURCE" "$OUTPUT_DIR/${suffix}_reload.s"
     fi
 }
 
+# Queue sjlj assembly with and without -fexceptions (sjlj compiler is C only)
+generate_sjlj() {
+    local suffix="$1"
+    local flags="$2"
+
+    queue sjlj "$COMMON_FLAGS $flags -fno-exceptions -fno-inline" "$SJLJ_SOURCE" "$OUTPUT_DIR/${suffix}_sjlj_noexc.s"
+    queue sjlj "$COMMON_FLAGS $flags -fexceptions -fno-inline" "$SJLJ_SOURCE" "$OUTPUT_DIR/${suffix}_sjlj_exc.s"
+}
+
 # Generate for different optimization levels
 generate "O2" "-O2"
 generate "O2_short" "-O2 -mshort"
@@ -102,6 +179,54 @@ generate "Os_68060" "-Os -m68060"
 generate "O2_cf" "-O2 -mcpu=5475"
 generate "Os_cf" "-Os -mcpu=5475"
 
+SOURCE_HASH=$(sha < "$SOURCE")
+SJLJ_SOURCE_HASH=""
+HASH_OLD=$(compiler_hash "$CC_OLD" cc1plus)
+HASH_NEW=$(compiler_hash "$CC_NEW" cc1plus)
+HASH_SJLJ=""
+
+if $SHOW_SJLJ; then
+    if [ ! -x ./build-host-sjlj/gcc/xgcc ]; then
+        echo "Error: ./build-host-sjlj/gcc/xgcc not found — run ./build-gcc.sh -sjlj build first"
+        exit 1
+    fi
+    > "$SJLJ_LOG"
+    SJLJ_SOURCE_HASH=$(sha < "$SJLJ_SOURCE")
+    HASH_SJLJ=$(compiler_hash "$CC_SJLJ" cc1)
+    generate_sjlj "O2" "-O2"
+    generate_sjlj "O2_short" "-O2 -mshort"
+    generate_sjlj "Os" "-Os"
+    generate_sjlj "Os_short" "-Os -mshort"
+fi
+
+export SOURCE SJLJ_SOURCE SOURCE_HASH SJLJ_SOURCE_HASH HASH_OLD HASH_NEW HASH_SJLJ
+export CC_OLD CC_NEW CC_SJLJ CACHE_DIR WORK_DIR USE_CACHE
+export -f now_ms sha compile_job
+
+wall_t0=$(now_ms)
+xargs -0 -n 4 -P "$JOBS" bash -c 'compile_job "$@"' _ < "$WORK_DIR/compile.jobs"
+wall_t1=$(now_ms)
+
+# Drop cache entries unused for two weeks
+find "$CACHE_DIR" -name '*.s' -mtime +14 -exec rm -f {} + 2>/dev/null || true
+
+# Accumulated build times (in milliseconds for precision)
+time_old_ms=0
+time_new_ms=0
+time_reload_ms=0  # only used with -reload
+cache_hits=0
+cache_jobs=0
+for t in "$WORK_DIR"/times/*; do
+    read -r which how ms < "$t"
+    cache_jobs=$((cache_jobs + 1))
+    [ "$how" = "cached" ] && cache_hits=$((cache_hits + 1))
+    case $which in
+        old)    time_old_ms=$((time_old_ms + ms)) ;;
+        new)    time_new_ms=$((time_new_ms + ms)) ;;
+        reload) time_reload_ms=$((time_reload_ms + ms)) ;;
+    esac
+done
+
 # Count instruction lines for comparison
 # Instructions start with a tab followed by a letter (excludes labels, directives, comments)
 count_instructions() {
@@ -115,18 +240,44 @@ count_cycles() {
     "$CLCCNT" -c "$cpu" "$file" 2>/dev/null | awk '{sum += $NF} END {print sum+0}'
 }
 
+# Estimated cycles are only modelled for the 68000; other CPUs in estimate
+# mode fall back to instruction counts.
+is_estimated() {
+    [ "$MODE" = "estimate" ] && [ "$1" = "000" ]
+}
+
 # Metric function: dispatches to cycles or instructions based on MODE
 count_metric() {
     local file="$1"
     local cpu="$2"
     if [ "$MODE" = "cycles" ]; then
         count_cycles "$file" "$cpu"
+    elif is_estimated "$cpu"; then
+        "$ANNOTATE" -s -c "$cpu" "$file" | awk '{sum += $2} END {print sum+0}'
     else
         count_instructions "$file"
     fi
 }
 
-# Compare per-function max cycles between old and new.
+# Per-function metric: "funcname value" lines.
+# With clccnt, value is max cycles; estimate mode uses static 68000 cycles;
+# otherwise instruction count.
+function_metrics() {
+    local file="$1"
+    local cpu="$2"
+    if [ "$MODE" = "cycles" ]; then
+        "$CLCCNT" -c "$cpu" "$file" 2>/dev/null | awk '{n=split($NF,a,"-"); print $1, (n>1 ? a[2] : a[1])}'
+    elif is_estimated "$cpu"; then
+        "$ANNOTATE" -s -c "$cpu" "$file" | awk '{print $1, $2}'
+    else
+        awk '/^[A-Za-z_][A-Za-z0-9_]*:/ { f = substr($0, 1, length($0) - 1); next }
+             /^\t\.size/ { f = "" }
+             /^\t[a-z]/ && f != "" { c[f]++ }
+             END { for (k in c) print k, c[k] }' "$file"
+    fi
+}
+
+# Compare per-function max (or estimated) cycles between old and new.
 # Outputs "regressions/improvements" where regressions = functions faster
 # in old, improvements = functions faster in new.
 # Also appends regressed functions to REGR_LOG.
@@ -136,14 +287,14 @@ count_regressions() {
     local new_file="$2"
     local cpu="$3"
     local variant_name="$4"
-    if [ -z "$CLCCNT" ]; then
+    if [ "$MODE" != "cycles" ] && ! is_estimated "$cpu"; then
         echo "-"
         return
     fi
     # Extract "funcname max_cycles" from each file
     local old_data new_data
-    old_data=$("$CLCCNT" -c "$cpu" "$old_file" 2>/dev/null | awk '{n=split($NF,a,"-"); print $1, (n>1 ? a[2] : a[1])}')
-    new_data=$("$CLCCNT" -c "$cpu" "$new_file" 2>/dev/null | awk '{n=split($NF,a,"-"); print $1, (n>1 ? a[2] : a[1])}')
+    old_data=$(function_metrics "$old_file" "$cpu")
+    new_data=$(function_metrics "$new_file" "$cpu")
     # Join on function name, count regressions/improvements
     # Lines starting with "R " are regression details, last line is the summary
     local result
@@ -177,6 +328,9 @@ echo ""
 if [ "$MODE" = "cycles" ]; then
     echo "Max Clock Cycle Comparison"
     echo "=========================="
+elif [ "$MODE" = "estimate" ]; then
+    echo "Estimated 68000 Clock Cycle Comparison (clccnt not found)"
+    echo "========================================================"
 else
     echo "Assembly Instruction Count Comparison"
     echo "======================================"
@@ -190,10 +344,18 @@ else
     printf "%-22s %8s %8s %8s %8s\n" "-------" "---" "---" "-----" "----"
 fi
 
-for variant in "O2:O2" "O2 -mshort:O2_short" "Os:Os" "Os -mshort:Os_short" "O2 -m68030:O2_68030" "Os -m68030:Os_68030" "O2 -m68040:O2_68040" "Os -m68040:Os_68040" "O2 -m68060:O2_68060" "Os -m68060:Os_68060" "O2 -mcpu=5475:O2_cf" "Os -mcpu=5475:Os_cf"; do
-    display_name="${variant%%:*}"
-    suffix="${variant##*:}"
+# One table row; regression details go to $WORK_DIR/rows/<idx>.regr
+variant_row() {
+    local idx="$1" variant="$2"
+    local REGR_LOG="$WORK_DIR/rows/$idx.regr"
+    local display_name="${variant%%:*}"
+    local suffix="${variant##*:}"
+    local cpu old_file new_file reload_file old_count new_count diff pct regr
+    local reload_count reload_diff reload_pct
     cpu=$(cpu_for_variant "$suffix")
+    if [ "$MODE" = "estimate" ] && ! is_estimated "$cpu"; then
+        display_name="$display_name *"
+    fi
 
     old_file="$OUTPUT_DIR/${suffix}_old.s"
     new_file="$OUTPUT_DIR/${suffix}_new.s"
@@ -229,8 +391,62 @@ for variant in "O2:O2" "O2 -mshort:O2_short" "Os:Os" "Os -mshort:Os_short" "O2 -
             printf "%-22s %8d %8d %7s%% %8s\n" "$display_name" "$old_count" "$new_count" "$pct" "$regr"
         fi
     fi
+}
+
+# Metrics for all variants in parallel, printed in table order
+export MODE CLCCNT ANNOTATE OUTPUT_DIR WORK_DIR SHOW_RELOAD
+export -f variant_row cpu_for_variant is_estimated count_metric count_instructions \
+    count_cycles function_metrics count_regressions
+idx=0
+for variant in "O2:O2" "O2 -mshort:O2_short" "Os:Os" "Os -mshort:Os_short" "O2 -m68030:O2_68030" "Os -m68030:Os_68030" "O2 -m68040:O2_68040" "Os -m68040:Os_68040" "O2 -m68060:O2_68060" "Os -m68060:Os_68060" "O2 -mcpu=5475:O2_cf" "Os -mcpu=5475:Os_cf"; do
+    idx=$((idx + 1))
+    printf '%s\0' "$(printf '%02d' "$idx")" "$variant"
+done | xargs -0 -n 2 -P "$JOBS" bash -c 'variant_row "$@" > "$WORK_DIR/rows/$1.row"' _
+for row in "$WORK_DIR"/rows/*.row; do
+    cat "$row"
+    if [ -f "${row%.row}.regr" ]; then
+        cat "${row%.row}.regr" >> "$REGR_LOG"
+    fi
 done
 
+if [ "$MODE" = "estimate" ]; then
+    echo "* instruction count (no 68000 cycle model; install clccnt)"
+fi
+
+# sjlj registration overhead: same compiler, -fexceptions vs -fno-exceptions.
+# Per-function overhead goes to SJLJ_LOG so regressions are visible in diffs.
+if $SHOW_SJLJ; then
+    echo ""
+    echo "sjlj Exception Overhead ($SJLJ_SOURCE)"
+    echo "=================================================="
+    echo ""
+    printf "%-22s %8s %8s %8s %8s\n" "Variant" "NoExc" "Exc" "Ovh" "Ovh/fn"
+    printf "%-22s %8s %8s %8s %8s\n" "-------" "-----" "---" "---" "------"
+    for variant in "O2:O2" "O2 -mshort:O2_short" "Os:Os" "Os -mshort:Os_short"; do
+        display_name="${variant%%:*}"
+        suffix="${variant##*:}"
+        noexc_file="$OUTPUT_DIR/${suffix}_sjlj_noexc.s"
+        exc_file="$OUTPUT_DIR/${suffix}_sjlj_exc.s"
+
+        if [ -f "$noexc_file" ] && [ -f "$exc_file" ]; then
+            noexc_count=$(count_metric "$noexc_file" "000")
+            exc_count=$(count_metric "$exc_file" "000")
+            ovh=$((exc_count - noexc_count))
+            nfuncs=$(function_metrics "$exc_file" "000" | grep -c '^test_' || true)
+            if [ "$nfuncs" -gt 0 ]; then
+                per_fn=$(awk "BEGIN {printf \"%.1f\", $ovh / $nfuncs}")
+            else
+                per_fn="-"
+            fi
+            printf "%-22s %8d %8d %+8d %8s\n" "$display_name" "$noexc_count" "$exc_count" "$ovh" "$per_fn"
+
+            # Join on function name: variant, function, no-exc, exc, overhead
+            join <(function_metrics "$noexc_file" "000" | sort) <(function_metrics "$exc_file" "000" | sort) |
+                awk -v var="$display_name" '$1 ~ /^test_/ { d = $3 - $2; print var "\t" $1 "\t" $2 "\t" $3 "\t" (d > 0 ? "+" : "") d }' >> "$SJLJ_LOG"
+        fi
+    done
+fi
+
 # Print build times
 time_old_s=$(awk "BEGIN {printf \"%.1f\", $time_old_ms / 1000}")
 time_new_s=$(awk "BEGIN {printf \"%.1f\", $time_new_ms / 1000}")
@@ -240,6 +456,13 @@ if $SHOW_RELOAD; then
 else
     printf "%-22s %7ss %7ss\n" "Time" "$time_old_s" "$time_new_s"
 fi
+wall_s=$(awk "BEGIN {printf \"%.1f\", ($wall_t1 - $wall_t0) / 1000}")
+echo "Compiled in ${wall_s}s wall with $JOBS jobs; $cache_hits/$cache_jobs from cache (-nocache to rebuild)"
 
 echo ""
 echo "Output directory: $(pwd)/$OUTPUT_DIR"
+
+if $RECORD; then
+    echo ""
+    ./debug-perf-history.sh record
+fi
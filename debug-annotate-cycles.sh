@@ -0,0 +1,414 @@
+#!/bin/bash
+# Annotate m68k assembly with per-instruction cycle and size estimates
+# See GCC_DEBUG.md section 1 for background
+
+set -e
+
+# --- Defaults ---
+CPU="000"
+FUNC=""
+TRIPS=8
+SUMMARY=false
+
+usage() {
+    cat <<EOF
+Usage: $0 [options] <file.s>
+
+Annotate each instruction with a 68000 cycle and byte estimate, as
+assembler comments. Each basic block, loop and function gets a total.
+Loop totals are weighted by an assumed trip count.
+
+Options:
+  -c CPU     CPU model (default: $CPU; only 000 is modelled)
+  -f FUNC    Annotate only function FUNC
+  -t TRIPS   Assumed iterations per loop (default: $TRIPS)
+  -s         Summary only: "function static weighted bytes" per line
+  -h         Show this help
+
+Examples:
+  $0 tmp/test_cases/Os_short_new.s
+  $0 -f test_copy tmp/test_cases/O2_new.s
+  $0 -s tmp/test_cases/O2_new.s
+EOF
+    exit 1
+}
+
+# --- Parse args ---
+while getopts "c:f:t:sh" opt; do
+    case $opt in
+        c) CPU="$OPTARG" ;;
+        f) FUNC="$OPTARG" ;;
+        t) TRIPS="$OPTARG" ;;
+        s) SUMMARY=true ;;
+        h) usage ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+SOURCE="${1:-}"
+if [ -z "$SOURCE" ]; then
+    echo "Error: no assembly file specified"
+    usage
+fi
+
+if [ ! -f "$SOURCE" ]; then
+    echo "Error: $SOURCE not found"
+    exit 1
+fi
+
+case "$CPU" in
+    000) ;;
+    *) echo "Error: no cycle model for CPU '$CPU' (only 000; the 68010 loop mode and faster"
+       echo "       mul/div/exceptions are not modelled; use clccnt for 020+)"; exit 1 ;;
+esac
+
+# --- Annotate ---
+# Timings are the MC68000 User's Manual tables (no wait states), taking the
+# maximum where the manual gives a range (mul/div, register-count shifts).
+# Sizes are opcode word + extension words; relaxable branches count as .w.
+awk -v func_filter="$FUNC" -v trips="$TRIPS" -v summary="$SUMMARY" '
+function is_dreg(op)  { return op ~ /^%d[0-7]$/ }
+function is_areg(op)  { return op ~ /^%(a[0-7]|sp|fp)$/ }
+
+# Classify an operand into an addressing mode name.
+function ea_mode(op,    nregs) {
+    if (op == "")                        return "none"
+    if (is_dreg(op))                     return "dn"
+    if (is_areg(op))                     return "an"
+    if (op ~ /^#/)                       return "imm"
+    if (op ~ /^\(%(a[0-7]|sp|fp)\)$/)    return "ind"
+    if (op ~ /^\(%(a[0-7]|sp|fp)\)\+$/)  return "postinc"
+    if (op ~ /^-\(%(a[0-7]|sp|fp)\)$/)   return "predec"
+    if (op ~ /\(/) {
+        # Two registers inside the parentheses means base + index
+        nregs = gsub(/%(d[0-7]|a[0-7]|sp|fp|pc)/, "&", op)
+        if (op ~ /%pc/)                  return (nregs > 1) ? "pcidx" : "pcdisp"
+        return (nregs > 1) ? "idx" : "disp"
+    }
+    if (op ~ /\.w$/)                     return "absw"
+    if (op ~ /^%/)                       return "other"
+    return "absl"
+}
+
+# Effective address calculation time (byte/word, long).
+function ea_time(mode, is_long) {
+    if (mode == "dn" || mode == "an" || mode == "none" || mode == "other") return 0
+    if (mode == "ind" || mode == "postinc") return is_long ? 8 : 4
+    if (mode == "predec")                  return is_long ? 10 : 6
+    if (mode == "disp" || mode == "pcdisp" || mode == "absw") return is_long ? 12 : 8
+    if (mode == "idx" || mode == "pcidx")  return is_long ? 14 : 10
+    if (mode == "absl")                    return is_long ? 16 : 12
+    if (mode == "imm")                     return is_long ? 8 : 4
+    return 0
+}
+
+# Destination write time for MOVE (predecrement costs the same as (An)).
+function move_dst_time(mode, is_long) {
+    if (mode == "predec") return is_long ? 8 : 4
+    if (mode == "imm") return 0
+    return ea_time(mode, is_long)
+}
+
+# Extension words in bytes.
+function ea_bytes(mode, is_long) {
+    if (mode == "disp" || mode == "pcdisp" || mode == "absw" || mode == "idx" || mode == "pcidx") return 2
+    if (mode == "absl") return 4
+    if (mode == "imm")  return is_long ? 4 : 2
+    return 0
+}
+
+# A movem register list: "%d2-%d7/%a2", "%a2/%a3" or a "#mask"; a single
+# register is "dn"/"an" already. "-8(%a6)" must not match.
+function is_reglist(op) {
+    return op ~ /^#/ || op ~ /^%(d[0-7]|a[0-7]|sp|fp)([-\/]%(d[0-7]|a[0-7]|sp|fp))+$/
+}
+
+function is_mem(mode) {
+    return mode != "dn" && mode != "an" && mode != "imm" && mode != "none" && mode != "other"
+}
+
+# Number of registers in a movem list ("%d2-%d7/%a2" or "#mask").
+function movem_count(list,    n, parts, i, r, lo, hi, m, c) {
+    if (list ~ /^#/) {
+        m = substr(list, 2) + 0; c = 0
+        while (m > 0) { c += m % 2; m = int(m / 2) }
+        return c
+    }
+    n = split(list, parts, "/"); c = 0
+    for (i = 1; i <= n; i++) {
+        if (parts[i] ~ /-/) {
+            split(parts[i], r, "-")
+            lo = substr(r[1], 3) + 0; hi = substr(r[2], 3) + 0
+            c += hi - lo + 1
+        } else {
+            c++
+        }
+    }
+    return c
+}
+
+# Split "src,dst" on the top-level comma (not inside parentheses).
+function split_operands(s,    i, ch, depth) {
+    OP1 = ""; OP2 = ""; depth = 0
+    for (i = 1; i <= length(s); i++) {
+        ch = substr(s, i, 1)
+        if (ch == "(") depth++
+        else if (ch == ")") depth--
+        else if (ch == "," && depth == 0) {
+            OP1 = substr(s, 1, i - 1); OP2 = substr(s, i + 1)
+            return
+        }
+    }
+    OP1 = s
+}
+
+# Shift count: immediate (#n) or register (assume 8, the manual gives 2n).
+function shift_count(op) {
+    if (op ~ /^#/) return substr(op, 2) + 0
+    return 8
+}
+
+# Estimate cycles (CYC) and bytes (LEN) for one instruction.
+function estimate(mn, ops,    base, sz, L, m1, m2, n, cnt) {
+    split_operands(ops)
+    base = mn; sz = "w"
+    if (mn ~ /\.[bwls]$/) { base = substr(mn, 1, length(mn) - 2); sz = substr(mn, length(mn)) }
+    L = (sz == "l")
+    m1 = ea_mode(OP1); m2 = ea_mode(OP2)
+    CYC = 4; LEN = 2 + ea_bytes(m1, L) + ea_bytes(m2, L)
+
+    if (base == "move" || base == "movea") {
+        CYC = 4 + ea_time(m1, L) + move_dst_time(m2, L)
+    } else if (base == "moveq") {
+        CYC = 4; LEN = 2
+    } else if (base ~ /^(add|sub|and|or|cmp|adda|suba|cmpa|addi|subi|andi|ori|eori|cmpi|eor)$/) {
+        if (m2 == "an" || base ~ /a$/) {
+            if (base ~ /^cmp/)       CYC = 6 + ea_time(m1, L)
+            else if (L)              CYC = ((m1 == "dn" || m1 == "an" || m1 == "imm") ? 8 : 6) + ea_time(m1, L)
+            else                     CYC = 8 + ea_time(m1, L)
+        } else if (m1 == "imm") {
+            # Immediate forms (addi/subi/... chosen by the assembler)
+            if (m2 == "dn")          CYC = (base ~ /^cmp/) ? (L ? 14 : 8) : (L ? 16 : 8)
+            else                     CYC = (base ~ /^cmp/) ? (L ? 12 : 8) + ea_time(m2, L) : (L ? 20 : 12) + ea_time(m2, L)
+        } else if (m2 == "dn") {
+            if (base ~ /^cmp/)       CYC = (L ? 6 : 4) + ea_time(m1, L)
+            else if (L)              CYC = ((m1 == "dn" || m1 == "an" || m1 == "imm") ? 8 : 6) + ea_time(m1, L)
+            else                     CYC = 4 + ea_time(m1, L)
+        } else {
+            CYC = (L ? 12 : 8) + ea_time(m2, L)
+        }
+    } else if (base == "addq" || base == "subq") {
+        LEN = 2 + ea_bytes(m2, L)
+        if (m2 == "dn")              CYC = L ? 8 : 4
+        else if (m2 == "an")         CYC = 8
+        else                         CYC = (L ? 12 : 8) + ea_time(m2, L)
+    } else if (base == "addx" || base == "subx") {
+        CYC = (m1 == "dn") ? (L ? 8 : 4) : (L ? 30 : 18)
+    } else if (base == "cmpm") {
+        CYC = L ? 20 : 12
+    } else if (base ~ /^(clr|neg|negx|not)$/) {
+        CYC = (m1 == "dn") ? (L ? 6 : 4) : (L ? 12 : 8) + ea_time(m1, L)
+    } else if (base == "tst") {
+        CYC = 4 + ea_time(m1, L)
+    } else if (base == "ext" || base == "swap" || base == "nop") {
+        CYC = 4
+    } else if (base == "exg") {
+        CYC = 6
+    } else if (base ~ /^(lsl|lsr|asl|asr|rol|ror|roxl|roxr)$/) {
+        if (OP2 == "") {
+            CYC = 8 + ea_time(m1, 0)
+        } else {
+            n = shift_count(OP1)
+            CYC = (L ? 8 : 6) + 2 * n
+            LEN = 2
+        }
+    } else if (base ~ /^mul[su]$/) {
+        CYC = 70 + ea_time(m1, 0)
+    } else if (base == "divu") {
+        CYC = 140 + ea_time(m1, 0)
+    } else if (base == "divs") {
+        CYC = 158 + ea_time(m1, 0)
+    } else if (base == "lea") {
+        if (m1 == "ind")                                        CYC = 4
+        else if (m1 == "disp" || m1 == "pcdisp" || m1 == "absw") CYC = 8
+        else if (m1 == "idx" || m1 == "pcidx" || m1 == "absl")   CYC = 12
+    } else if (base == "pea") {
+        CYC = 8 + ((m1 == "ind") ? 4 : (m1 == "idx" || m1 == "pcidx" || m1 == "absl") ? 12 : 8)
+    } else if (base == "movem") {
+        if (m1 == "dn" || m1 == "an" || is_reglist(OP1)) {
+            cnt = movem_count(OP1)
+            CYC = (m2 == "predec" || m2 == "ind" ? 8 : 12) + (L ? 8 : 4) * cnt
+            LEN = 4 + ea_bytes(m2, 0)
+        } else {
+            cnt = movem_count(OP2)
+            CYC = (m1 == "postinc" || m1 == "ind" ? 12 : 16) + (L ? 8 : 4) * cnt
+            LEN = 4 + ea_bytes(m1, 0)
+        }
+    } else if (base ~ /^s(t|f|hi|ls|cc|cs|ne|eq|vc|vs|pl|mi|ge|lt|gt|le)$/) {
+        CYC = (m1 == "dn") ? 6 : 8 + ea_time(m1, 0)
+    } else if (base ~ /^b(tst|set|clr|chg)$/) {
+        if (m2 == "dn") {
+            if (base == "btst")      CYC = (m1 == "imm") ? 10 : 6
+            else if (base == "bclr") CYC = (m1 == "imm") ? 14 : 10
+            else                     CYC = (m1 == "imm") ? 12 : 8
+        } else {
+            if (base == "btst")      CYC = ((m1 == "imm") ? 8 : 4) + ea_time(m2, 0)
+            else                     CYC = ((m1 == "imm") ? 12 : 8) + ea_time(m2, 0)
+        }
+        LEN = 2 + (m1 == "imm" ? 2 : 0) + ea_bytes(m2, 0)
+    } else if (base ~ /^(jra|bra|jbra)$/) {
+        CYC = 10; LEN = (sz == "s") ? 2 : 4
+    } else if (base ~ /^(j|b)(hi|ls|cc|cs|ne|eq|vc|vs|pl|mi|ge|lt|gt|le|hs|lo)$/) {
+        # Taken branch; not-taken is 8 (.s) or 12 (.w)
+        CYC = 10; LEN = (sz == "s") ? 2 : 4
+    } else if (base ~ /^db/) {
+        CYC = 10; LEN = 4
+    } else if (base ~ /^(jbsr|bsr)$/) {
+        CYC = 18; LEN = 4
+    } else if (base == "jsr") {
+        CYC = (m1 == "ind") ? 16 : (m1 == "absl") ? 20 : (m1 == "idx" || m1 == "pcidx") ? 22 : 18
+        LEN = 2 + ea_bytes(m1, 0)
+    } else if (base == "jmp") {
+        CYC = (m1 == "ind") ? 8 : (m1 == "absl") ? 12 : (m1 == "idx" || m1 == "pcidx") ? 14 : 10
+        LEN = 2 + ea_bytes(m1, 0)
+    } else if (base == "rts") {
+        CYC = 16; LEN = 2
+    } else if (base == "rte" || base == "rtr") {
+        CYC = 20; LEN = 2
+    } else if (base == "link") {
+        CYC = 16; LEN = 4
+    } else if (base == "unlk") {
+        CYC = 12; LEN = 2
+    } else if (base == "trap") {
+        CYC = 34; LEN = 2
+    }
+}
+
+function flush_block(    name) {
+    if (bb_insns > 0 && summary != "true" && in_func) {
+        name = (bb_label != "") ? bb_label : "(fallthrough)"
+        printf "\t| bb %s: %d cycles, %d bytes\n", name, bb_cyc, bb_len
+    }
+    bb_cyc = 0; bb_len = 0; bb_insns = 0; bb_label = ""
+}
+
+function end_function(    i, j, d, w, mult, k, hdr) {
+    flush_block()
+    # Loops: a branch back to a label defined earlier in this function.
+    # Back edges to the same header (e.g. a "continue" jne and the bottom
+    # jra) are one loop, ending at the furthest latch.
+    nloops = 0
+    delete loop_of
+    for (i = 1; i <= ninsn; i++) {
+        hdr = itarget[i]
+        if (hdr != "" && (hdr in label_at) && label_at[hdr] <= i) {
+            if (hdr in loop_of) {
+                lend[loop_of[hdr]] = i
+            } else {
+                loop_of[hdr] = ++nloops
+                lstart[nloops] = label_at[hdr]; lend[nloops] = i; lname[nloops] = hdr
+            }
+        }
+    }
+    static_cyc = 0; weighted = 0; total_len = 0
+    for (i = 1; i <= ninsn; i++) {
+        d = 0
+        for (j = 1; j <= nloops; j++)
+            if (i >= lstart[j] && i <= lend[j]) d++
+        mult = 1
+        for (k = 0; k < d; k++) mult *= trips
+        static_cyc += icyc[i]; total_len += ilen[i]; weighted += icyc[i] * mult
+    }
+    if (summary == "true") {
+        printf "%s %d %d %d\n", cur_func, static_cyc, weighted, total_len
+    } else {
+        for (j = 1; j <= nloops; j++) {
+            w = 0
+            for (i = lstart[j]; i <= lend[j]; i++) w += icyc[i]
+            printf "\t| loop %s: %d cycles/iteration x %d = %d\n", lname[j], w, trips, w * trips
+        }
+        printf "\t| %s: %d cycles static, %d weighted (x%d per loop level), %d bytes\n", cur_func, static_cyc, weighted, trips, total_len
+    }
+    delete label_at; delete icyc; delete ilen; delete itarget
+    ninsn = 0; in_func = 0; cur_func = ""
+}
+
+function out(line) { if (summary != "true" && (in_func || func_filter == "")) print line }
+
+BEGIN { in_func = 0; ninsn = 0; in_text = 1 }
+
+# Section changes; only .text labels can start functions
+/^\t\.(text|data|bss)([ \t]|$)/ { in_text = ($0 ~ /^\t\.text/) }
+/^\t\.section[ \t]/ { sec = $2; sub(/,.*/, "", sec); in_text = (sec ~ /^\.text/) }
+
+# ".type name, @function" marks the labels that are functions
+/^\t\.type[ \t]/ {
+    if ($0 ~ /@function/) { name = $2; sub(/,.*/, "", name); is_func[name] = 1 }
+    out($0)
+    next
+}
+
+# Function start: a column-0 label declared @function; data labels such as
+# "g_x:" are left alone
+/^[A-Za-z_][A-Za-z0-9_.$]*:/ {
+    name = substr($0, 1, index($0, ":") - 1)
+    if (in_text && (name in is_func)) {
+        if (in_func) end_function()
+        if (func_filter == "" || name == func_filter || name == "_" func_filter) {
+            in_func = 1; cur_func = name; ninsn = 0
+        }
+    }
+    out($0)
+    next
+}
+
+# Local label
+/^\.[A-Za-z0-9_.$]+:/ {
+    name = substr($0, 1, index($0, ":") - 1)
+    if (in_func) {
+        flush_block()
+        bb_label = name
+        label_at[name] = ninsn + 1
+    }
+    out($0)
+    next
+}
+
+# End of function
+/^\t\.size/ {
+    if (in_func) { out($0); end_function(); next }
+    out($0)
+    next
+}
+
+# Instruction
+/^\t[a-z]/ {
+    if (!in_func) { out($0); next }
+    line = $0
+    sub(/^\t/, "", line)
+    sub(/[ \t]*\|.*$/, "", line)
+    mn = line; ops = ""
+    if (match(line, /[ \t]+/)) {
+        mn = substr(line, 1, RSTART - 1)
+        ops = substr(line, RSTART + RLENGTH)
+        gsub(/[ \t]/, "", ops)
+    }
+    if (mn ~ /^\./) { out($0); next }
+    estimate(mn, ops)
+    ninsn++
+    icyc[ninsn] = CYC; ilen[ninsn] = LEN; itarget[ninsn] = ""
+    if (mn ~ /^(j|b|db)/ && mn !~ /^(btst|bset|bclr|bchg|bsr|jbsr|jsr)/) {
+        t = ops; sub(/^.*,/, "", t)
+        itarget[ninsn] = t
+    }
+    bb_cyc += CYC; bb_len += LEN; bb_insns++
+    out(sprintf("%s\t| %dc %db", $0, CYC, LEN))
+    if (mn ~ /^(j|b|db)/ && mn !~ /^(btst|bset|bclr|bchg|bsr|jbsr|jsr)/ || mn == "rts") flush_block()
+    next
+}
+
+{ out($0) }
+
+END { if (in_func) end_function() }
+' "$SOURCE"
@@ -9,8 +9,15 @@ OPT_FLAGS="-Os -mshort -mfastcall"
 EXTRA_FLAGS=""
 FUNC=""
 ICE_MODE=false
+PAIRS=false
+DDMIN=false
+GCC_PASSES=false
+PARAMS=()
+TARGET=""
+JOBS=$(sysctl -n hw.ncpu 2>/dev/null || nproc 2>/dev/null || echo 4)
 
 XGCC="./build-host/gcc/xgcc"
+CC_OLD="m68k-atari-mintelf-gcc"
 OUTDIR="./tmp/debug"
 
 # m68k-specific flags to iterate, ordered by pass execution phase
@@ -49,18 +56,33 @@ usage() {
 Usage: $0 [options] <source.c>
 
 Disable each m68k pass individually to find which one causes a change.
+All compilations of a sweep run in parallel.
 
 Options:
   -f FUNC    Focus on function FUNC only
   -O FLAGS   Optimization flags (default: $OPT_FLAGS)
   -x FLAGS   Extra compiler flags
   -ice       Search for ICE failures instead of instruction count changes
+  -pairs     Also disable every pair of flags and report interactions
+             (pairs whose effect differs from the two single effects)
+  -dd        Delta-debug the smallest set of disabled flags that reaches
+             the target count (see -target) or makes the ICE go away
+  -target N  Instruction count to reach with -dd (default: the stock
+             compiler's count, else the count with all m68k passes off)
+  -gcc       Bisect GCC's own passes (-fdisable-tree-*/-fdisable-rtl-*
+             from -fdump-passes) instead of the m68k flags
+  -param NAME=LO:HI[:STEP]
+             Sweep a numeric --param over a range (repeatable)
+  -j N       Parallel compilations (default: $JOBS)
   -h         Show this help
 
 Examples:
   $0 test.c
   $0 -f my_func test.c
   $0 -ice test.c
+  $0 -pairs -dd -f my_func test.c
+  $0 -gcc -dd -ice test.c
+  $0 -param max-loop-header-insns-for-size=0:8 -f my_func test.c
 EOF
     exit 1
 }
@@ -69,13 +91,19 @@ EOF
 # Manual parsing to support -ice (multi-char flag)
 while [ $# -gt 0 ]; do
     case "$1" in
-        -f)   FUNC="$2"; shift 2 ;;
-        -O)   OPT_FLAGS="$2"; shift 2 ;;
-        -x)   EXTRA_FLAGS="$2"; shift 2 ;;
-        -ice) ICE_MODE=true; shift ;;
-        -h)   usage ;;
-        -*)   echo "Unknown option: $1"; usage ;;
-        *)    break ;;
+        -f)      FUNC="$2"; shift 2 ;;
+        -O)      OPT_FLAGS="$2"; shift 2 ;;
+        -x)      EXTRA_FLAGS="$2"; shift 2 ;;
+        -ice)    ICE_MODE=true; shift ;;
+        -pairs)  PAIRS=true; shift ;;
+        -dd)     DDMIN=true; shift ;;
+        -target) TARGET="$2"; shift 2 ;;
+        -gcc)    GCC_PASSES=true; shift ;;
+        -param)  PARAMS+=("$2"); shift 2 ;;
+        -j)      JOBS="$2"; shift 2 ;;
+        -h)      usage ;;
+        -*)      echo "Unknown option: $1"; usage ;;
+        *)       break ;;
     esac
 done
 
@@ -95,15 +123,33 @@ if [ ! -f "$XGCC" ]; then
     exit 1
 fi
 
+for spec in "${PARAMS[@]}"; do
+    if ! [[ "$spec" =~ ^[a-z0-9-]+=([0-9]+):([0-9]+)(:([0-9]+))?$ ]]; then
+        echo "Error: bad -param '$spec' (expected NAME=LO:HI[:STEP])"
+        exit 1
+    fi
+    # 10# so leading zeros are not read as octal
+    if [ $((10#${BASH_REMATCH[1]})) -gt $((10#${BASH_REMATCH[2]})) ]; then
+        echo "Error: -param '$spec' has LO > HI"
+        exit 1
+    fi
+    if [ -n "${BASH_REMATCH[4]}" ] && [ $((10#${BASH_REMATCH[4]})) -eq 0 ]; then
+        echo "Error: -param '$spec' has STEP 0"
+        exit 1
+    fi
+done
+
 # --- Setup ---
 mkdir -p "$OUTDIR"
 BASE=$(basename "$SOURCE" | sed 's/\.[^.]*$//')
 FLAGS="$OPT_FLAGS $EXTRA_FLAGS -fno-inline"
+rm -f "${OUTDIR:?}/${BASE}"_*.res
 
 echo -e "${BOLD}Source:${RESET} $SOURCE"
 echo -e "${BOLD}Flags:${RESET}  $FLAGS"
 [ -n "$FUNC" ] && echo -e "${BOLD}Function:${RESET} $FUNC"
 $ICE_MODE && echo -e "${BOLD}Mode:${RESET}  ICE detection"
+echo -e "${BOLD}Jobs:${RESET}   $JOBS"
 echo ""
 
 # --- Extract a function from assembly (ELF bare name or a.out _ prefix) ---
@@ -146,16 +192,95 @@ get_ice_message() {
     grep "internal compiler error" "$1.err" 2>/dev/null | head -1
 }
 
-if $ICE_MODE; then
-    # === ICE detection mode ===
+# --- Compile one variant and record "count status" in <name>.s.res ---
+# Status is ok, ice, or error (no ICE but no usable output, e.g. a pass that
+# cannot be disabled). Input is "name flags...".
+eval_variant() {
+    local name="${1%% *}" flags="${1#* }"
+    [ "$flags" = "$1" ] && flags=""
+    local outfile="$OUTDIR/${BASE}_${name}.s"
+    [ -f "$outfile.res" ] && return 0
+    rm -f "$outfile"
+    # shellcheck disable=SC2086
+    compile "$outfile" $flags
+    local status=ok
+    if has_ice "$outfile"; then
+        status=ice
+    elif [ ! -s "$outfile" ] || grep -q "error:" "$outfile.err"; then
+        status=error
+    fi
+    local count=0
+    [ -f "$outfile" ] && count=$(count_insns "$outfile")
+    echo "$count $status" > "$outfile.res"
+}
+export -f eval_variant compile has_ice count_insns extract_func
+export XGCC FLAGS SOURCE OUTDIR BASE FUNC
 
-    # --- Baseline ---
-    BASELINE="$OUTDIR/${BASE}_baseline.s"
-    compile "$BASELINE"
-    baseline_ice=false
-    if has_ice "$BASELINE"; then
-        baseline_ice=true
+# Run "name flags..." lines from stdin in parallel
+run_batch() {
+    tr '\n' '\0' | xargs -0 -n 1 -P "$JOBS" bash -c 'eval_variant "$1"' _
+}
+
+# "count status" of a finished variant
+result_of() {
+    cat "$OUTDIR/${BASE}_$1.s.res"
+}
+
+# --- Candidate flags ---
+if $GCC_PASSES; then
+    # Every tree/rtl pass that runs for these flags, as -fdisable-<pass>
+    CANDS=()
+    while read -r pass; do
+        CANDS+=("-fdisable-$pass")
+    done < <("$XGCC" -B./build-host/gcc $FLAGS -fdump-passes -S "$SOURCE" -o /dev/null 2>&1 |
+             awk '$1 ~ /^(tree|rtl)-[A-Za-z0-9_.-]+$/ && $NF == "ON" { print $1 }' | awk '!seen[$0]++')
+    if [ ${#CANDS[@]} -eq 0 ]; then
+        echo "Error: -fdump-passes listed no passes"
+        exit 1
     fi
+    CAND_LABEL="GCC pass"
+else
+    CANDS=("${M68K_FLAGS[@]}")
+    CAND_LABEL="m68k"
+fi
+
+# Variant name for a set of candidate indices (file-name safe)
+set_name() {
+    echo "set_$(echo "$*" | cksum | awk '{print $1}')"
+}
+
+set_flags() {
+    local i flags=""
+    for i in "$@"; do flags="$flags ${CANDS[$i]}"; done
+    echo "${flags# }"
+}
+
+# Does a variant reach the goal? ICE mode: compiles without ICE.
+# Count mode: compiles and has at most $TARGET instructions.
+reaches_goal() {
+    local count status
+    read -r count status <<< "$(result_of "$1")"
+    [ "$status" = ok ] || return 1
+    $ICE_MODE && return 0
+    [ "$count" -le "$TARGET" ]
+}
+
+# --- Sweep: baseline, all disabled, and each flag on its own ---
+{
+    echo "baseline"
+    $GCC_PASSES || echo "all_disabled ${M68K_FLAGS[*]}"
+    for flag in "${CANDS[@]}"; do
+        echo "$flag $flag"
+    done
+} | run_batch
+
+read -r baseline_count baseline_status <<< "$(result_of baseline)"
+BASELINE="$OUTDIR/${BASE}_baseline.s"
+baseline_ice=false
+[ "$baseline_status" = ice ] && baseline_ice=true
+
+if $ICE_MODE; then
+    # === ICE detection mode ===
 
     # --- Print table header ---
     printf "\n${BOLD}%-35s  %s${RESET}\n" "Pass" "ICE?"
@@ -169,36 +294,27 @@ if $ICE_MODE; then
         printf "%-35s  ${DIM}ok${RESET}\n" "baseline (all enabled)"
     fi
 
-    # --- All m68k passes disabled ---
-    ALL_DISABLED="$OUTDIR/${BASE}_all_disabled.s"
-    compile "$ALL_DISABLED" "${M68K_FLAGS[@]}"
-    if has_ice "$ALL_DISABLED"; then
-        printf "%-35s  ${RED}ICE${RESET}\n" "all m68k disabled"
-        echo -e "  ${DIM}$(get_ice_message "$ALL_DISABLED")${RESET}"
-    else
-        state="ok"
-        # Highlight if baseline ICEs but this doesn't (= m68k pass is the culprit)
-        if $baseline_ice; then
-            state="${GREEN}ok (ICE gone!)${RESET}"
-        else
-            state="${DIM}ok${RESET}"
-        fi
-        printf "%-35s  $state\n" "all m68k disabled"
-    fi
+    rows=()
+    $GCC_PASSES || rows+=("all_disabled:all m68k disabled")
+    for flag in "${CANDS[@]}"; do rows+=("$flag:$flag"); done
 
-    # --- Each pass individually ---
-    for flag in "${M68K_FLAGS[@]}"; do
-        outfile="$OUTDIR/${BASE}_${flag}.s"
-        compile "$outfile" "$flag"
-
-        if has_ice "$outfile"; then
-            printf "%-35s  ${RED}ICE${RESET}\n" "$flag"
+    for row in "${rows[@]}"; do
+        name="${row%%:*}" label="${row#*:}"
+        outfile="$OUTDIR/${BASE}_${name}.s"
+        read -r count status <<< "$(result_of "$name")"
+        if [ "$status" = ice ]; then
+            printf "%-35s  ${RED}ICE${RESET}\n" "$label"
             echo -e "  ${DIM}$(get_ice_message "$outfile")${RESET}"
+        elif [ "$status" = error ]; then
+            $GCC_PASSES && continue     # not every pass can be disabled
+            printf "%-35s  ${RED}error${RESET}\n" "$label"
         else
+            # Highlight if baseline ICEs but this doesn't (= disabled pass is the culprit)
             if $baseline_ice; then
-                printf "%-35s  ${GREEN}ok (ICE gone!)${RESET}\n" "$flag"
+                printf "%-35s  ${GREEN}ok (ICE gone!)${RESET}\n" "$label"
             else
-                printf "%-35s  ${DIM}ok${RESET}\n" "$flag"
+                $GCC_PASSES && continue
+                printf "%-35s  ${DIM}ok${RESET}\n" "$label"
             fi
         fi
     done
@@ -206,17 +322,6 @@ if $ICE_MODE; then
 else
     # === Instruction count mode ===
 
-    # --- Baseline (all passes enabled) ---
-    BASELINE="$OUTDIR/${BASE}_baseline.s"
-    compile "$BASELINE"
-    baseline_count=$(count_insns "$BASELINE")
-
-    # --- All m68k passes disabled ---
-    ALL_DISABLED="$OUTDIR/${BASE}_all_disabled.s"
-    compile "$ALL_DISABLED" "${M68K_FLAGS[@]}"
-    all_disabled_count=$(count_insns "$ALL_DISABLED")
-    all_diff=$((all_disabled_count - baseline_count))
-
     # --- Print table header ---
     printf "\n${BOLD}%-35s %6s %6s  %s${RESET}\n" "Pass" "Insns" "Diff" "Changed?"
     printf "%-35s %6s %6s  %s\n" "---" "-----" "----" "--------"
@@ -224,27 +329,215 @@ else
     # Baseline row
     printf "%-35s %6d\n" "baseline (all enabled)" "$baseline_count"
 
-    # All disabled row
-    if [ "$all_diff" -ne 0 ]; then
-        printf "%-35s %6d %+5d  ${GREEN}YES${RESET}\n" "all m68k disabled" "$all_disabled_count" "$all_diff"
+    rows=()
+    $GCC_PASSES || rows+=("all_disabled:all m68k disabled")
+    for flag in "${CANDS[@]}"; do rows+=("$flag:$flag"); done
+
+    for row in "${rows[@]}"; do
+        name="${row%%:*}" label="${row#*:}"
+        read -r count status <<< "$(result_of "$name")"
+        diff=$((count - baseline_count))
+        if [ "$status" != ok ]; then
+            # GCC passes that cannot be disabled are not interesting
+            $GCC_PASSES && continue
+            printf "%-35s %6s %6s  ${RED}%s${RESET}\n" "$label" "-" "-" "$status"
+        elif [ "$diff" -ne 0 ]; then
+            printf "%-35s %6d %+5d  ${GREEN}YES${RESET}\n" "$label" "$count" "$diff"
+        elif ! $GCC_PASSES; then
+            printf "%-35s %6d %5d  ${DIM}no${RESET}\n" "$label" "$count" "$diff"
+        fi
+    done
+    if $GCC_PASSES; then
+        echo -e "${DIM}(${#CANDS[@]} passes tried; only those that change the output are shown)${RESET}"
+    fi
+fi
+
+# --- Candidates for pairs/dd: all m68k flags, or the GCC passes that
+# changed something on their own (pairs of ~300 passes are not practical) ---
+SEARCH=()
+for i in "${!CANDS[@]}"; do
+    if $GCC_PASSES; then
+        read -r count status <<< "$(result_of "${CANDS[$i]}")"
+        [ "$status" = error ] && continue
+        if $ICE_MODE; then
+            [ "$status" != "$baseline_status" ] || continue
+        else
+            [ "$status" = ok ] && [ "$count" -ne "$baseline_count" ] || continue
+        fi
+    fi
+    SEARCH+=("$i")
+done
+
+# --- Pairwise interactions ---
+if $PAIRS; then
+    n=${#SEARCH[@]}
+    {
+        for ((a = 0; a < n; a++)); do
+            for ((b = a + 1; b < n; b++)); do
+                i=${SEARCH[$a]} j=${SEARCH[$b]}
+                echo "$(set_name "$i" "$j") $(set_flags "$i" "$j")"
+            done
+        done
+    } | run_batch
+
+    echo ""
+    if $ICE_MODE; then
+        echo -e "${BOLD}Pairs that change the ICE state only together${RESET}"
     else
-        printf "%-35s %6d %5d  ${DIM}no${RESET}\n" "all m68k disabled" "$all_disabled_count" "$all_diff"
+        echo -e "${BOLD}Pairs whose effect is not the sum of the single effects${RESET}"
+        printf "${BOLD}%-58s %6s %6s %8s${RESET}\n" "Pair" "Insns" "Diff" "Expected"
     fi
+    found=0
+    for ((a = 0; a < n; a++)); do
+        for ((b = a + 1; b < n; b++)); do
+            i=${SEARCH[$a]} j=${SEARCH[$b]}
+            read -r ci si <<< "$(result_of "${CANDS[$i]}")"
+            read -r cj sj <<< "$(result_of "${CANDS[$j]}")"
+            read -r cp sp <<< "$(result_of "$(set_name "$i" "$j")")"
+            label="${CANDS[$i]} + ${CANDS[$j]}"
+            if $ICE_MODE; then
+                if [ "$si" = "$baseline_status" ] && [ "$sj" = "$baseline_status" ] && [ "$sp" != "$baseline_status" ]; then
+                    printf "%-58s  %s\n" "$label" "$sp"
+                    found=$((found + 1))
+                fi
+            elif [ "$si" = ok ] && [ "$sj" = ok ] && [ "$sp" = ok ]; then
+                expected=$(( (ci - baseline_count) + (cj - baseline_count) ))
+                diff=$((cp - baseline_count))
+                if [ "$diff" -ne "$expected" ]; then
+                    printf "%-58s %6d %+5d %+7d\n" "$label" "$cp" "$diff" "$expected"
+                    found=$((found + 1))
+                fi
+            fi
+        done
+    done
+    [ "$found" -eq 0 ] && echo -e "  ${DIM}none among $((n * (n - 1) / 2)) pairs${RESET}"
+fi
 
-    # --- Each pass individually ---
-    for flag in "${M68K_FLAGS[@]}"; do
-        outfile="$OUTDIR/${BASE}_${flag}.s"
-        compile "$outfile" "$flag"
-        count=$(count_insns "$outfile")
-        diff=$((count - baseline_count))
+# --- Delta debugging: smallest set of disabled flags that reaches the goal ---
+# ddmin over SEARCH. Each round compiles every chunk and complement of the
+# current partition in parallel, then keeps the first that reaches the goal.
+if $DDMIN; then
+    echo ""
+    if ! $ICE_MODE && [ -z "$TARGET" ]; then
+        if command -v "$CC_OLD" &>/dev/null; then
+            "$CC_OLD" $FLAGS -S "$SOURCE" -o "$OUTDIR/${BASE}_old.s" 2>/dev/null || true
+            TARGET=$(count_insns "$OUTDIR/${BASE}_old.s")
+            target_from="stock compiler"
+        elif ! $GCC_PASSES; then
+            read -r TARGET _ <<< "$(result_of all_disabled)"
+            target_from="all m68k passes disabled"
+        else
+            echo "Error: -dd with -gcc needs -target N (stock compiler not found)"
+            exit 1
+        fi
+    else
+        target_from="-target"
+    fi
+    if $ICE_MODE; then
+        echo -e "${BOLD}Delta debugging:${RESET} smallest set of disabled $CAND_LABEL flags that avoids the ICE"
+        if ! $baseline_ice; then
+            echo "  Baseline does not ICE; nothing to do"
+            DDMIN=false
+        fi
+    else
+        echo -e "${BOLD}Delta debugging:${RESET} smallest set of disabled $CAND_LABEL flags with <= $TARGET insns ($target_from)"
+        if reaches_goal baseline; then
+            echo "  Baseline already has $baseline_count insns; nothing to do"
+            DDMIN=false
+        fi
+    fi
+fi
+
+if $DDMIN; then
+    current=("${SEARCH[@]}")
+    echo "$(set_name "${current[@]}") $(set_flags "${current[@]}")" | run_batch
+    if [ ${#current[@]} -eq 0 ] || ! reaches_goal "$(set_name "${current[@]}")"; then
+        echo "  Disabling all ${#current[@]} candidates does not reach the goal"
+        echo "  (the cause is outside these flags, or needs passes that cannot be disabled)"
+        DDMIN=false
+    fi
+fi
 
-        if [ "$diff" -ne 0 ]; then
-            printf "%-35s %6d %+5d  ${GREEN}YES${RESET}\n" "$flag" "$count" "$diff"
+if $DDMIN; then
+    gran=2
+    tests=1
+    while [ ${#current[@]} -ge 2 ]; do
+        size=${#current[@]}
+        [ $gran -gt $size ] && gran=$size
+
+        # Partition into $gran chunks; list chunks first, then complements
+        subsets=()
+        for ((c = 0; c < gran; c++)); do
+            lo=$((c * size / gran)) hi=$(((c + 1) * size / gran))
+            chunk="" rest=""
+            for ((k = 0; k < size; k++)); do
+                if [ $k -ge $lo ] && [ $k -lt $hi ]; then chunk="$chunk ${current[$k]}"
+                else rest="$rest ${current[$k]}"; fi
+            done
+            subsets[$c]="${chunk# }"
+            subsets[$((gran + c))]="${rest# }"
+        done
+        # With two chunks each complement is the other chunk
+        [ $gran -eq 2 ] && subsets=("${subsets[0]}" "${subsets[1]}")
+
+        for s in "${subsets[@]}"; do
+            # shellcheck disable=SC2086
+            echo "$(set_name $s) $(set_flags $s)"
+        done | run_batch
+        tests=$((tests + ${#subsets[@]}))
+
+        picked=-1
+        for idx in "${!subsets[@]}"; do
+            # shellcheck disable=SC2086
+            if reaches_goal "$(set_name ${subsets[$idx]})"; then picked=$idx; break; fi
+        done
+
+        if [ $picked -ge 0 ]; then
+            read -r -a current <<< "${subsets[$picked]}"
+            if [ $picked -lt $gran ]; then gran=2
+            else gran=$((gran > 2 ? gran - 1 : 2)); fi
+        elif [ $gran -ge $size ]; then
+            break
         else
-            printf "%-35s %6d %5d  ${DIM}no${RESET}\n" "$flag" "$count" "$diff"
+            gran=$((gran * 2))
         fi
     done
+
+    result=$(set_name "${current[@]}")
+    read -r count status <<< "$(result_of "$result")"
+    echo -e "  ${GREEN}$(set_flags "${current[@]}")${RESET}"
+    if $ICE_MODE; then
+        echo "  compiles without ICE (${tests} test sets)"
+    else
+        echo "  $count insns (baseline $baseline_count, ${tests} test sets)"
+    fi
+    echo -e "  ${DIM}Assembly: $OUTDIR/${BASE}_${result}.s${RESET}"
 fi
 
+# --- Numeric --param sweeps ---
+for spec in "${PARAMS[@]}"; do
+    pname="${spec%%=*}" range="${spec#*=}"
+    lo="${range%%:*}" rest="${range#*:}"
+    hi="${rest%%:*}" step=1
+    [ "$rest" != "$hi" ] && step="${rest#*:}"
+    lo=$((10#$lo)) hi=$((10#$hi)) step=$((10#$step))
+
+    for ((v = lo; v <= hi; v += step)); do
+        echo "param_${pname}_$v --param=$pname=$v"
+    done | run_batch
+
+    echo ""
+    printf "${BOLD}%-35s %6s %6s  %s${RESET}\n" "--param=$pname" "Insns" "Diff" "Status"
+    printf "%-35s %6s %6s  %s\n" "---" "-----" "----" "------"
+    for ((v = lo; v <= hi; v += step)); do
+        read -r count status <<< "$(result_of "param_${pname}_$v")"
+        if [ "$status" = ok ]; then
+            printf "%-35s %6d %+5d  %s\n" "$v" "$count" $((count - baseline_count)) "ok"
+        else
+            printf "%-35s %6s %6s  ${RED}%s${RESET}\n" "$v" "-" "-" "$status"
+        fi
+    done
+done
+
 echo ""
 echo -e "${DIM}Temp files in $OUTDIR/${RESET}"
@@ -0,0 +1,366 @@
+#!/bin/bash
+# Measure how the compile time of the m68k passes scales with function size
+# See GCC_DEBUG.md section 3 for background
+
+set -e
+
+# --- Defaults ---
+OPT_FLAGS="-O2 -fomit-frame-pointer"
+EXTRA_FLAGS=""
+CC_NEW="./build-host/gcc/xgcc -B./build-host/gcc"
+SIZES="250 500 1000 2000"
+GENERATE=true
+MIKROS_DIR=""
+MIKROS_TOP=5
+REPEAT=3
+DISABLE=false
+MAX_SHARE=10
+MAX_GROWTH=1.5
+OTHERS=5
+
+OUTDIR="./tmp/compile-time"
+
+# --- Colors (only if stdout is a terminal) ---
+if [ -t 1 ]; then
+    BOLD='\033[1m'
+    RED='\033[1;31m'
+    RESET='\033[0m'
+else
+    BOLD="" RED="" RESET=""
+fi
+
+usage() {
+    cat <<EOF
+Usage: $0 [options] [source.c|source.i ...]
+
+Compile generated large functions (and optionally real sources) with
+-ftime-report and show the time spent in each m68k pass, how it grows
+with function size, and the slowest GCC timevars for comparison.
+
+Options:
+  -s SIZES     Generated function sizes in blocks of ~8 statements
+               (default: "$SIZES")
+  -nogen       Do not compile generated functions
+  -mikros DIR  Add the largest preprocessed sources (.i/.ii) of a
+               build-mikros.sh --report work dir
+  -n N         How many mikros sources to add (default: $MIKROS_TOP)
+  -O FLAGS     Optimization flags (default: $OPT_FLAGS)
+  -x FLAGS     Extra compiler flags (e.g. "-fchecking=2" or "--param ...")
+  -cc CC       Compiler (default: $CC_NEW)
+  -r N         Runs per input, fastest wins (default: $REPEAT)
+  -disable     Also time each m68k pass by disabling it (-fdisable-*);
+               works without m68k timevars in -ftime-report
+  -t PCT       Fail if the m68k passes take more than PCT% of any
+               compilation (default: $MAX_SHARE)
+  -e EXP       Fail if an m68k pass grows faster than size^EXP over the
+               generated functions (default: $MAX_GROWTH)
+  -h           Show this help
+
+Examples:
+  $0
+  $0 -s "500 1000 2000 4000 8000" -disable
+  $0 -nogen -mikros /tmp/build-mikros-12345 -n 10
+  $0 -x "-fchecking=2" SDL/src/video/SDL_blit_N.c
+EOF
+    exit 1
+}
+
+# --- Parse args ---
+# Manual parsing to support multi-char flags
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -s)        SIZES="$2"; shift 2 ;;
+        -nogen)    GENERATE=false; shift ;;
+        -mikros)   MIKROS_DIR="$2"; shift 2 ;;
+        -n)        MIKROS_TOP="$2"; shift 2 ;;
+        -O)        OPT_FLAGS="$2"; shift 2 ;;
+        -x)        EXTRA_FLAGS="$2"; shift 2 ;;
+        -cc)       CC_NEW="$2"; shift 2 ;;
+        -r)        REPEAT="$2"; shift 2 ;;
+        -disable)  DISABLE=true; shift ;;
+        -t)        MAX_SHARE="$2"; shift 2 ;;
+        -e)        MAX_GROWTH="$2"; shift 2 ;;
+        -h)        usage ;;
+        -*)        echo "Unknown option: $1"; usage ;;
+        *)         break ;;
+    esac
+done
+
+SOURCES=("$@")
+for src in "${SOURCES[@]}"; do
+    [ -f "$src" ] || { echo "Error: $src not found"; exit 1; }
+done
+if [ -n "$MIKROS_DIR" ] && [ ! -d "$MIKROS_DIR" ]; then
+    echo "Error: $MIKROS_DIR not found"
+    exit 1
+fi
+if ! $GENERATE && [ ${#SOURCES[@]} -eq 0 ] && [ -z "$MIKROS_DIR" ]; then
+    echo "Error: nothing to compile"
+    usage
+fi
+# shellcheck disable=SC2086
+set -- $CC_NEW
+if ! command -v "$1" &>/dev/null; then
+    echo "Error: $1 not found — run ./build-gcc.sh build first"
+    exit 1
+fi
+
+# --- Setup ---
+mkdir -p "$OUTDIR"
+rm -f "${OUTDIR:?}"/*.tv
+FLAGS="$OPT_FLAGS $EXTRA_FLAGS"
+
+# --- Generated inputs ---
+# One straight-line function of N blocks, as heavy inlining produces (SDL
+# blitters, mpg123 synth). The blocks rotate through the shapes the m68k
+# passes look at: sequential MEMs with pointer bumps (reorder-incr,
+# opt-autoinc), zero-extends and masks (elim-andi), copies that are
+# available on some paths only (avail-copy-elim), and short diamonds that
+# split pointer walks across blocks (cross-BB autoinc). Every 16 blocks are
+# wrapped in a loop so doloop and the loop-aware passes have work too.
+generate() {
+    local n="$1" out="$2"
+    perl -e '
+        my $n = shift;
+        print "void gen_$n(unsigned short *d, const unsigned short *s, unsigned x, int n)\n{\n";
+        print "    unsigned acc = x, a = x >> 3, b = x << 2, t;\n    int j;\n\n";
+        for my $i (0 .. $n - 1) {
+            print "    for (j = 0; j < n; j++) {\n" if $i % 16 == 0;
+            my $k = $i % 4;
+            if ($k == 0) {
+                print "        d[0] = s[0] ^ acc; d[1] = s[1] + a; d[2] = s[2] - b; d[3] = s[3] | acc;\n";
+                print "        d += 4; s += 4;\n";
+            } elsif ($k == 1) {
+                print "        acc += (unsigned char)(acc >> 8) + (b & 0xff);\n";
+                print "        b = (unsigned short)(acc * 3) + ((a >> 16) & 0xff);\n";
+            } elsif ($k == 2) {
+                printf "        if (acc & 0x%x) { t = a; a = b; b = t; } else { *d++ = (unsigned short)a; }\n", 1 << ($i % 16);
+                print "        a = b;\n";
+            } else {
+                printf "        if (n & %d) *d = *s++; else *d = *s++ + acc;\n", $i % 7 + 1;
+                print "        d++;\n";
+            }
+            print "    }\n" if $i % 16 == 15 || $i == $n - 1;
+        }
+        print "}\n";
+    ' "$n" > "$out"
+}
+
+INPUTS=()
+GEN_INPUTS=()
+if $GENERATE; then
+    for n in $SIZES; do
+        generate "$n" "$OUTDIR/gen_$n.c"
+        INPUTS+=("$OUTDIR/gen_$n.c")
+        GEN_INPUTS+=("$OUTDIR/gen_$n.c")
+    done
+fi
+
+# Largest preprocessed files kept by build-mikros.sh --report (-save-temps)
+if [ -n "$MIKROS_DIR" ]; then
+    tree="$MIKROS_DIR/build-non-sjlj"
+    [ -d "$tree" ] || tree="$MIKROS_DIR"
+    while IFS= read -r f; do
+        INPUTS+=("$f")
+    done < <(find "$tree" \( -name '*.i' -o -name '*.ii' \) ! -name 'conftest*' -print0 |
+             perl -0ne 'chomp; print -s $_, "\t$_\n"' | sort -rn | head -n "$MIKROS_TOP" | cut -f2)
+    if [ ${#INPUTS[@]} -eq ${#GEN_INPUTS[@]} ]; then
+        echo "Error: no .i files in $tree — build with ./build-mikros.sh --report"
+        exit 1
+    fi
+fi
+INPUTS+=("${SOURCES[@]}")
+
+# --- Timing ---
+# Wall seconds per timevar of one -ftime-report run: "timevar<TAB>secs".
+# Handles both the usr/sys/wall and the wall-only column layouts.
+parse_time_report() {
+    perl -ne '
+        if (/^Time variable\s+(.*)$/) {
+            my @cols = grep { $_ ne "GGC" } split " ", $1;
+            ($wall) = grep { $cols[$_] eq "wall" } 0 .. $#cols;
+            next;
+        }
+        next unless defined $wall && /^\s*(\S.*?)\s*:\s*(.*)$/;
+        my ($name, $rest) = ($1, $2);
+        my @t = $rest =~ /(\d+\.\d+)(?![\dkMG])/g;
+        print "$name\t$t[$wall]\n" if defined $t[$wall];
+    '
+}
+
+# Fastest of $REPEAT -ftime-report runs of <input> with extra <flags>,
+# written to <out>. Returns 1 if the compiler fails.
+time_report() {
+    local input="$1" flags="$2" out="$3" i tmp total best=""
+    tmp="$out.run"
+    for ((i = 0; i < REPEAT; i++)); do
+        # shellcheck disable=SC2086
+        $CC_NEW $FLAGS $flags -ftime-report -S "$input" -o /dev/null 2> "$tmp.err" || return 1
+        parse_time_report < "$tmp.err" > "$tmp"
+        total=$(awk -F'\t' '$1 == "TOTAL" { print $2 }' "$tmp")
+        if [ -z "$best" ] || awk -v a="$total" -v b="$best" 'BEGIN { exit !(a < b) }'; then
+            best="$total"
+            mv "$tmp" "$out"
+        fi
+    done
+    rm -f "$tmp" "$tmp.err"
+}
+
+# Short column label for an input
+label_of() {
+    local name
+    name=$(basename "$1")
+    name="${name%.*}"
+    echo "${name:0:10}"
+}
+
+# Timevar file for an input; keyed by path since multilib copies share names
+tv_of() {
+    echo "$OUTDIR/$(echo "$1" | sed 's|^\./||; s|[/.]|_|g').tv"
+}
+
+echo -e "${BOLD}Compiler:${RESET} $CC_NEW"
+echo -e "${BOLD}Flags:${RESET}    $FLAGS -ftime-report (fastest of $REPEAT)"
+echo ""
+
+for input in "${INPUTS[@]}"; do
+    tv=$(tv_of "$input")
+    shown="$input"
+    [ -n "$MIKROS_DIR" ] && shown="${input#"$MIKROS_DIR"/}"
+    printf "  %-50s " "$shown"
+    if ! time_report "$input" "" "$tv"; then
+        echo "compile failed (see $tv.run.err)"
+        exit 1
+    fi
+
+    if $DISABLE; then
+        # Pass names from -fdump-passes; a disabled pass still costs its
+        # gate, so this slightly underestimates the pass itself.
+        base=$(awk -F'\t' '$1 == "TOTAL" { print $2 }' "$tv")
+        # shellcheck disable=SC2086
+        while IFS= read -r pass; do
+            time_report "$input" "-fdisable-$pass" "$tv.dis" || continue
+            awk -F'\t' -v p="$pass" -v base="$base" '
+                $1 == "TOTAL" { d = base - $2; printf "disabled %s\t%.2f\n", p, (d > 0 ? d : 0) }' "$tv.dis" >> "$tv"
+        done < <($CC_NEW $FLAGS -fdump-passes -S "$input" -o /dev/null 2>&1 |
+                 awk '$1 ~ /^(tree|rtl)-m68k[A-Za-z0-9_.-]*$/ && $NF == "ON" { print $1 }' | awk '!seen[$0]++')
+        rm -f "$tv.dis" "$tv.dis.run.err"
+    fi
+    awk -F'\t' '$1 == "TOTAL" { printf "%6.2fs\n", $2 }' "$tv"
+done
+echo ""
+
+# --- Report ---
+# Table of <inputs...> (one column each): m68k timevars, disabled-pass
+# deltas, the slowest other timevars, and totals. <sizes> enables the
+# growth column: the exponent k in time ~ size^k between the first and
+# last input where the row is measurable.
+# Prints "FAIL <reason>" lines for budget violations.
+report() {
+    local sizes="$1"; shift
+    local files=() labels="" input
+    for input in "$@"; do
+        files+=("$(tv_of "$input")")
+        labels="$labels $(label_of "$input")"
+    done
+    awk -F'\t' -v labels="$labels" -v sizes="$sizes" -v others="$OTHERS" \
+        -v max_share="$MAX_SHARE" -v max_growth="$MAX_GROWTH" '
+        FNR == 1 { col++ }
+        {
+            t[$1, col] = $2
+            if (!($1 in seen)) { seen[$1] = 1; names[++nn] = $1 }
+            if ($1 == "TOTAL") total[col] = $2
+        }
+        function is_m68k(n)  { return n ~ /m68k/ && n !~ /^disabled / }
+        function is_other(n) { return n !~ /m68k/ && n != "TOTAL" && n !~ /^phase / }
+        function row(n,    c, line, lo, hi, k) {
+            line = sprintf("%-36s", n)
+            for (c = 1; c <= col; c++) line = line sprintf(" %10.2f", t[n, c])
+            if (ns > 1) {
+                lo = hi = 0
+                for (c = 1; c <= col; c++) if (t[n, c] >= 0.05) { if (!lo) lo = c; hi = c }
+                if (lo && hi > lo && t[n, lo] > 0) {
+                    k = log(t[n, hi] / t[n, lo]) / log(sz[hi] / sz[lo])
+                    line = line sprintf("  x^%.1f", k)
+                    if ((is_m68k(n) || n ~ /^disabled /) && k > max_growth) {
+                        line = line " !"
+                        fail[++nf] = sprintf("%s grows as size^%.1f (limit %s)", n, k, max_growth)
+                    }
+                } else line = line "      -"
+            }
+            print line
+        }
+        END {
+            ncl = split(labels, lab, " ")
+            ns = split(sizes, sz, " ")
+            hdr = sprintf("%-36s", "Timevar (wall s)")
+            for (c = 1; c <= ncl; c++) hdr = hdr sprintf(" %10s", lab[c])
+            if (ns > 1) hdr = hdr sprintf("  %5s", "Growth")
+            print hdr
+            sep = hdr; gsub(/./, "-", sep); print sep
+
+            # m68k rows in pass order as GCC reported them
+            for (i = 1; i <= nn; i++) if (is_m68k(names[i])) { row(names[i]); nm++
+                for (c = 1; c <= col; c++) m68k[c] += t[names[i], c] }
+            for (i = 1; i <= nn; i++) if (names[i] ~ /^disabled /) { row(names[i]); nd++ }
+            if (!nm && !nd) print "(no m68k timevars in -ftime-report; use -disable)"
+            print sep
+
+            # Slowest other timevars by their worst share of a compilation
+            for (i = 1; i <= nn; i++) {
+                n = names[i]; if (!is_other(n)) continue
+                share[n] = 0
+                for (c = 1; c <= col; c++) if (total[c] > 0 && t[n, c] / total[c] > share[n]) share[n] = t[n, c] / total[c]
+            }
+            for (k = 1; k <= others; k++) {
+                best = ""
+                for (n in share) if (!(n in shown) && (best == "" || share[n] > share[best])) best = n
+                if (best == "") break
+                shown[best] = 1; row(best)
+            }
+            print sep
+
+            if (nm) {
+                line = sprintf("%-36s", "m68k timevars")
+                for (c = 1; c <= col; c++) line = line sprintf(" %10.2f", m68k[c])
+                print line
+                line = sprintf("%-36s", "  share of TOTAL")
+                for (c = 1; c <= col; c++) {
+                    p = total[c] > 0 ? m68k[c] * 100 / total[c] : 0
+                    line = line sprintf(" %9.1f%%", p)
+                    if (p > max_share) fail[++nf] = sprintf("m68k passes take %.1f%% of %s (limit %s%%)", p, lab[c], max_share)
+                }
+                print line
+            }
+            row("TOTAL")
+            for (i = 1; i <= nf; i++) print "FAIL " fail[i]
+        }' "${files[@]}"
+}
+
+FAILED=false
+show() {
+    local out
+    out=$(report "$@")
+    echo "$out" | grep -v '^FAIL ' || true
+    if echo "$out" | grep -q '^FAIL '; then
+        echo ""
+        echo "$out" | sed -n 's/^FAIL /Over budget: /p' | while IFS= read -r line; do
+            echo -e "${RED}$line${RESET}"
+        done
+        FAILED=true
+    fi
+    echo ""
+}
+
+if [ ${#GEN_INPUTS[@]} -gt 0 ]; then
+    echo -e "${BOLD}=== Generated functions (blocks: $SIZES) ===${RESET}"
+    show "$SIZES" "${GEN_INPUTS[@]}"
+fi
+if [ ${#INPUTS[@]} -gt ${#GEN_INPUTS[@]} ]; then
+    echo -e "${BOLD}=== Sources ===${RESET}"
+    show "" "${INPUTS[@]:${#GEN_INPUTS[@]}}"
+fi
+
+echo "Per-input timevars: $OUTDIR/*.tv (timevar<TAB>wall seconds)"
+$FAILED && exit 1
+exit 0
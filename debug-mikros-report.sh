@@ -0,0 +1,198 @@
+#!/bin/bash
+# Compare per-function text size and static cycles across build-mikros.sh
+# trees (stock, non-sjlj, sjlj)
+# See GCC_DEBUG.md section 1 for background
+
+set -e
+
+# --- Defaults ---
+TOP=10
+METRIC="size"
+REPORT=""
+NM="m68k-atari-mintelf-nm"
+ANNOTATE="$(cd "$(dirname "$0")" && pwd)/debug-annotate-cycles.sh"
+JOBS=$(sysctl -n hw.ncpu 2>/dev/null || nproc 2>/dev/null || echo 4)
+
+usage() {
+    cat <<EOF
+Usage: $0 [options] <build-mikros work dir>
+
+Walk every object file in the build-stock/, build-non-sjlj/ and build-sjlj/
+trees of a build-mikros.sh run and compare the text size of each function
+(from nm) and its static 68000 cycle estimate (debug-annotate-cycles.sh on
+the .s kept by build-mikros.sh --report). The first tree present is the
+reference: stock, else non-sjlj.
+
+Options:
+  -m METRIC  Rank movers by size or cycles (default: $METRIC)
+  -n N       Movers per package in the report file (default: $TOP)
+  -o FILE    Report file (default: <work dir>/report.txt)
+  -h         Show this help
+
+Examples:
+  $0 /tmp/build-mikros-12345
+  $0 -m cycles -n 20 /tmp/build-mikros-12345
+  ./build-mikros.sh --stock --report        # builds, then runs this
+EOF
+    exit 1
+}
+
+# --- Parse args ---
+while getopts "m:n:o:h" opt; do
+    case $opt in
+        m) METRIC="$OPTARG" ;;
+        n) TOP="$OPTARG" ;;
+        o) REPORT="$OPTARG" ;;
+        h) usage ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+WORK_DIR="${1:-}"
+if [ -z "$WORK_DIR" ] || [ ! -d "$WORK_DIR" ]; then
+    echo "Error: no build-mikros.sh work directory specified"
+    usage
+fi
+WORK_DIR=$(cd "$WORK_DIR" && pwd)
+case "$METRIC" in
+    size|cycles) ;;
+    *) echo "Error: unknown metric '$METRIC'"; usage ;;
+esac
+[ -n "$REPORT" ] || REPORT="$WORK_DIR/report.txt"
+command -v "$NM" &>/dev/null || { echo "Error: $NM not found on PATH"; exit 1; }
+
+TREES=()
+for label in stock non-sjlj sjlj; do
+    [ -d "$WORK_DIR/build-$label" ] && TREES+=("$label")
+done
+if [ ${#TREES[@]} -lt 2 ]; then
+    echo "Error: need at least two of build-stock, build-non-sjlj, build-sjlj in $WORK_DIR"
+    exit 1
+fi
+
+TMP_DIR="$WORK_DIR/report.tmp"
+rm -rf "${TMP_DIR:?}"
+mkdir -p "$TMP_DIR"
+
+# Metrics for a batch of objects, relative to the tree root:
+# "package<TAB>object<TAB>function<TAB>size<TAB>cycles"
+# The package is the top directory (source tree plus multilib suffix).
+# libtool's .libs/ objects are keyed like their parent directory.
+obj_metrics() {
+    local out o s
+    out=$(mktemp "$TMP_DIR/part.XXXXXX")
+    for o in "$@"; do
+        s="${o%.o}.s"
+        [ -f "$s" ] || s=/dev/null
+        {
+            "$NM" -S -t d --defined-only "$o" 2>/dev/null | awk 'NF == 4 && $3 ~ /^[tT]$/ { print "nm", $4, $2 + 0 }'
+            [ "$s" != /dev/null ] && "$ANNOTATE" -s "$s" 2>/dev/null | awk '{ print "cy", $1, $2 }'
+        } | awk -v obj="$o" '
+            $1 == "nm" { size[$2] = $3; next }
+            $1 == "cy" { cyc[$2] = $3 }
+            END {
+                key = obj; sub(/\/\.libs\//, "/", key); sub(/^\.\//, "", key)
+                pkg = key; sub(/\/.*/, "", pkg)
+                for (f in size) print pkg "\t" key "\t" f "\t" size[f] "\t" cyc[f]
+            }' >> "$out"
+    done
+}
+export -f obj_metrics
+export NM ANNOTATE TMP_DIR
+
+echo "=== Collecting metrics from ${TREES[*]} ==="
+for label in "${TREES[@]}"; do
+    (
+        cd "$WORK_DIR/build-$label"
+        find . -name '*.o' ! -name 'conftest*' -print0 |
+            xargs -0 -n 64 -P "$JOBS" bash -c 'obj_metrics "$@"' _
+    )
+    # Two objects can map to one key (foo.o and .libs/foo.o); keep one
+    cat "$TMP_DIR"/part.* 2>/dev/null | sort -t"$(printf '\t')" -k2,3 -u > "$TMP_DIR/$label.tsv"
+    rm -f "$TMP_DIR"/part.*
+    printf "  %-10s %6d functions\n" "$label" "$(wc -l < "$TMP_DIR/$label.tsv")"
+done
+echo ""
+
+# Reference, compared tree, and sjlj as an extra column when all three exist
+REF="${TREES[0]}"
+NEW="${TREES[1]}"
+SJLJ="${TREES[2]:-}"
+
+# Per-package totals and movers. Functions missing on either side are
+# counted as added/removed and left out of the totals.
+awk -F'\t' -v ref="$REF" -v new="$NEW" -v sjlj="$SJLJ" -v top="$TOP" -v metric="$METRIC" -v report="$REPORT" '
+    function pct(a, b) { return a > 0 ? (b - a) * 100 / a : 0 }
+    FILENAME ~ ("/" ref ".tsv$")  { r_sz[$2 SUBSEP $3] = $4; r_cy[$2 SUBSEP $3] = $5; r_pkg[$2 SUBSEP $3] = $1; next }
+    sjlj != "" && FILENAME ~ ("/" sjlj ".tsv$") { s_sz[$2 SUBSEP $3] = $4; s_cy[$2 SUBSEP $3] = $5; next }
+    {
+        k = $2 SUBSEP $3
+        if (!(k in r_sz)) added[$1]++
+        else {
+            seen[k] = 1; pk = $1; pkgs[pk] = 1
+            rs[pk] += r_sz[k]; ns[pk] += $4
+            if (r_cy[k] != "" && $5 != "") { rc[pk] += r_cy[k]; nc[pk] += $5 }
+            if (k in s_sz) { ss[pk] += s_sz[k]; sr[pk] += r_sz[k] }
+            d = metric == "size" ? $4 - r_sz[k] : ($5 != "" && r_cy[k] != "" ? $5 - r_cy[k] : 0)
+            if (d > 0) worse[pk]++
+            else if (d < 0) better[pk]++
+            if (d != 0) {
+                n = ++nm[pk]; mv_d[pk, n] = d; mv_k[pk, n] = k
+                mv_t[pk, n] = sprintf("%6d -> %6d bytes  %6s -> %6s cycles", r_sz[k], $4, r_cy[k], $5)
+            }
+        }
+    }
+    END {
+        for (k in r_sz) if (!(k in seen)) removed[r_pkg[k]]++
+
+        np = 0
+        for (p in pkgs) names[++np] = p
+        for (i = 1; i <= np; i++) for (j = i + 1; j <= np; j++) if (names[j] < names[i]) { t = names[i]; names[i] = names[j]; names[j] = t }
+
+        hdr = sprintf("%-28s %9s %9s %7s %10s %10s %7s %5s %5s", "Package", ref, new, "Size%", "cyc:" ref, "cyc:" new, "Cyc%", "Worse", "Bettr")
+        if (sjlj != "") hdr = hdr sprintf(" %7s", "sjlj%")
+        print hdr
+        gsub(/[^ ]/, "-", hdr); print hdr
+        for (i = 1; i <= np; i++) {
+            p = names[i]
+            line = sprintf("%-28s %9d %9d %6.1f%% %10d %10d %6.1f%% %5d %5d", p, rs[p], ns[p], pct(rs[p], ns[p]), rc[p], nc[p], pct(rc[p], nc[p]), worse[p], better[p])
+            if (sjlj != "") line = line sprintf(" %6.1f%%", pct(sr[p], ss[p]))
+            print line
+            trs += rs[p]; tns += ns[p]; trc += rc[p]; tnc += nc[p]; tw += worse[p]; tb += better[p]; tss += ss[p]; tsr += sr[p]
+        }
+        print hdr
+        line = sprintf("%-28s %9d %9d %6.1f%% %10d %10d %6.1f%% %5d %5d", "TOTAL", trs, tns, pct(trs, tns), trc, tnc, pct(trc, tnc), tw, tb)
+        if (sjlj != "") line = line sprintf(" %6.1f%%", pct(tsr, tss))
+        print line
+
+        # Movers per package, worst first, into the report file
+        for (i = 1; i <= np; i++) {
+            p = names[i]; n = nm[p]
+            for (a = 2; a <= n; a++) {
+                d = mv_d[p, a]; k = mv_k[p, a]; t = mv_t[p, a]
+                for (b = a - 1; b >= 1 && mv_d[p, b] < d; b--) { mv_d[p, b+1] = mv_d[p, b]; mv_k[p, b+1] = mv_k[p, b]; mv_t[p, b+1] = mv_t[p, b] }
+                mv_d[p, b+1] = d; mv_k[p, b+1] = k; mv_t[p, b+1] = t
+            }
+            printf "== %s (%d added, %d removed) ==\n", p, added[p], removed[p] > report
+            printf "Largest %s regressions:\n", metric > report
+            for (a = 1; a <= n && a <= top && mv_d[p, a] > 0; a++) {
+                split(mv_k[p, a], kk, SUBSEP)
+                printf "  %+7d  %-36s %-40s %s\n", mv_d[p, a], kk[2], kk[1], mv_t[p, a] > report
+            }
+            printf "Largest %s wins:\n", metric > report
+            for (a = n; a >= 1 && a > n - top && mv_d[p, a] < 0; a--) {
+                split(mv_k[p, a], kk, SUBSEP)
+                printf "  %+7d  %-36s %-40s %s\n", mv_d[p, a], kk[2], kk[1], mv_t[p, a] > report
+            }
+            print "" > report
+        }
+    }
+' "$TMP_DIR/$REF.tsv" ${SJLJ:+"$TMP_DIR/$SJLJ.tsv"} "$TMP_DIR/$NEW.tsv"
+
+echo ""
+echo "Sizes are text bytes from $NM -S; cycles are static 68000 estimates and"
+echo "stay empty without the .s files from build-mikros.sh --report."
+[ -n "$SJLJ" ] && echo "sjlj%: sjlj vs $REF text size."
+echo "Per-package movers ($METRIC): $REPORT"
+echo "Per-function data: $TMP_DIR/*.tsv (package object function size cycles)"
@@ -0,0 +1,271 @@
+#!/bin/bash
+# Collect and summarize per-pass transform counters (-fdump-statistics)
+# See GCC_DEBUG.md section 2 for background
+
+set -e
+
+# --- Defaults ---
+OPT_FLAGS="-Os -mshort -mfastcall"
+EXTRA_FLAGS=""
+PASS_RE=""
+JSON=false
+TOP=30
+HISTOGRAMS=false
+CYCLES=false
+JOBS=$(sysctl -n hw.ncpu 2>/dev/null || nproc 2>/dev/null || echo 4)
+
+XGCC="./build-host/gcc/xgcc"
+OUTDIR="./tmp/stats"
+ANNOTATE="$(cd "$(dirname "$0")" && pwd)/debug-annotate-cycles.sh"
+
+# m68k pass flags for -c, as in debug-bisect-passes.sh
+M68K_FLAGS=(
+    "-mno-m68k-narrow-index-mult"
+    "-fno-ivopts-autoinc-step"
+    "-mno-m68k-autoinc"
+    "-mno-m68k-reorder-mem"
+    "-mno-m68k-doloop"
+    "-mno-m68k-avail-copy-elim"
+    "-mno-m68k-ira-promote"
+    "-mno-m68k-btst-extract"
+    "-mno-m68k-highword-opt"
+    "-mno-m68k-elim-andi"
+    "-mno-m68k-insn-cost"
+)
+
+usage() {
+    cat <<EOF
+Usage: $0 [options] <source.c | dir | file.statistics...>
+
+Report how often each pass fired, from GCC's statistics counters.
+
+  source.c          Compile with the new compiler and -fdump-statistics
+  dir               Summarize every *.statistics file below dir
+                    (e.g. from ./build-mikros.sh --stats)
+  file.statistics   Summarize the given dump files
+
+Options:
+  -O FLAGS   Optimization flags for source mode (default: $OPT_FLAGS)
+  -x FLAGS   Extra compiler flags for source mode
+  -p REGEX   Only passes matching REGEX (e.g. 'm68k|peephole2|doloop')
+  -j         JSON lines: one record per function with per-pass counters
+  -n N       Show the top N counters in the table (default: $TOP)
+  -H         Keep histogram counters ("... == N"), dropped by default
+  -c         Source mode: also estimate each m68k pass's cycle delta per
+             function (68000 model of debug-annotate-cycles.sh, with the
+             pass on minus with its -mno-* flag); -p filters the flags
+  -h         Show this help
+
+Examples:
+  $0 test.c
+  $0 -p m68k -j test.c > test.jsonl
+  $0 -c -p 'autoinc|doloop' test.c
+  $0 -p 'm68k|doloop' /tmp/build-mikros-1234/stats-non-sjlj
+EOF
+    exit 1
+}
+
+# --- Parse args ---
+while getopts "O:x:p:jn:Hch" opt; do
+    case $opt in
+        O) OPT_FLAGS="$OPTARG" ;;
+        x) EXTRA_FLAGS="$OPTARG" ;;
+        p) PASS_RE="$OPTARG" ;;
+        j) JSON=true ;;
+        n) TOP="$OPTARG" ;;
+        H) HISTOGRAMS=true ;;
+        c) CYCLES=true ;;
+        h) usage ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -eq 0 ]; then
+    echo "Error: no source file, directory or statistics file specified"
+    usage
+fi
+
+# --- Collect statistics files ---
+# Each entry is "label<TAB>path"; label identifies the translation unit.
+STATS_LIST=$(mktemp)
+CYCLE_LIST=$(mktemp)
+trap 'rm -f "$STATS_LIST" "$CYCLE_LIST"' EXIT
+
+for arg in "$@"; do
+    if [ -d "$arg" ]; then
+        find "$arg" -name '*.statistics' | sort | while read -r f; do
+            rel="${f#$arg/}"
+            # Strip ".NNNt.statistics" (GCC naming) or ".PID.statistics" (wrapper naming)
+            printf "%s\t%s\n" "$(echo "$rel" | sed -E 's/\.[0-9]+t?\.statistics$//')" "$f"
+        done >> "$STATS_LIST"
+    elif [[ "$arg" == *.statistics ]] && [ -f "$arg" ]; then
+        printf "%s\t%s\n" "$(basename "$arg" | sed -E 's/\.[0-9]+t?\.statistics$//')" "$arg" >> "$STATS_LIST"
+    elif [ -f "$arg" ]; then
+        if [ ! -f "$XGCC" ]; then
+            echo "Error: $XGCC not found — run ./build-gcc.sh build first"
+            exit 1
+        fi
+        mkdir -p "$OUTDIR"
+        base=$(basename "$arg")
+        stats="$OUTDIR/${base}.statistics"
+        # shellcheck disable=SC2086
+        "$XGCC" -B./build-host/gcc $OPT_FLAGS $EXTRA_FLAGS -S -o /dev/null \
+            -fdump-statistics="$stats" "$arg"
+        printf "%s\t%s\n" "$base" "$stats" >> "$STATS_LIST"
+        printf "%s\t%s\n" "$base" "$arg" >> "$CYCLE_LIST"
+    else
+        echo "Error: $arg not found"
+        exit 1
+    fi
+done
+
+if [ ! -s "$STATS_LIST" ]; then
+    echo "Error: no statistics files found"
+    exit 1
+fi
+if $CYCLES && [ ! -s "$CYCLE_LIST" ]; then
+    echo "Error: -c needs a source file (dumps and directories have no assembly)"
+    exit 1
+fi
+if $CYCLES && [[ " $OPT_FLAGS $EXTRA_FLAGS" =~ \ -m(680[2-6]0|cpu=|cfv) ]]; then
+    echo "Note: cycle deltas use the 68000 timing model whatever -m flags are given" >&2
+fi
+
+# --- Cycle deltas (-c) ---
+# Compile every source as-is and once per m68k flag, in parallel, and keep
+# the per-function "function static weighted bytes" summaries.
+# Emits: label flag function static weighted bytes (pass on minus off;
+# negative means the pass saves cycles), nonzero rows only.
+cycle_job() {
+    local out="$1" src="$2" flag="$3"
+    # shellcheck disable=SC2086
+    if "$XGCC" -B./build-host/gcc $OPT_FLAGS $EXTRA_FLAGS $flag -S -o "$out" "$src" 2>/dev/null; then
+        "$ANNOTATE" -s "$out" > "$out.cyc"
+    else
+        : > "$out.cyc"
+    fi
+}
+
+cycle_deltas() {
+    local label src flag i dir
+    dir="$OUTDIR/cycles"
+    mkdir -p "$dir"
+    rm -f "${dir:?}"/*
+    while IFS=$'\t' read -r label src; do
+        printf '%s\0%s\0%s\0' "$dir/$label.base.s" "$src" ""
+        for i in "${!M68K_FLAGS[@]}"; do
+            flag="${M68K_FLAGS[$i]}"
+            [ -n "$PASS_RE" ] && ! [[ "$flag" =~ $PASS_RE ]] && continue
+            printf '%s\0%s\0%s\0' "$dir/$label.$i.s" "$src" "$flag"
+        done
+    done < "$CYCLE_LIST" > "$dir/jobs"
+    export -f cycle_job
+    export XGCC OPT_FLAGS EXTRA_FLAGS ANNOTATE
+    xargs -0 -n 3 -P "$JOBS" bash -c 'cycle_job "$@"' _ < "$dir/jobs"
+
+    while IFS=$'\t' read -r label src; do
+        for i in "${!M68K_FLAGS[@]}"; do
+            [ -f "$dir/$label.$i.s.cyc" ] || continue
+            awk -v label="$label" -v flag="${M68K_FLAGS[$i]}" '
+                FNR == NR { s[$1] = $2; w[$1] = $3; b[$1] = $4; next }
+                ($1 in s) && (s[$1] != $2 || w[$1] != $3 || b[$1] != $4) {
+                    print label "\t" flag "\t" $1 "\t" s[$1] - $2 "\t" w[$1] - $3 "\t" b[$1] - $4
+                }' "$dir/$label.base.s.cyc" "$dir/$label.$i.s.cyc"
+        done
+    done < "$CYCLE_LIST"
+}
+
+# --- Parse ---
+# Dump lines look like: 123 combine "two-insn combine" "func" 4
+# Emit: label pass counter function count (tab-separated)
+parse_stats() {
+    while IFS=$'\t' read -r label path; do
+        sed -nE 's/^[0-9]+ ([^ ]+) "(.*)" "(.*)" ([0-9]+)$/\1\t\2\t\3\t\4/p' "$path" |
+            awk -F'\t' -v label="$label" -v re="$PASS_RE" -v hist="$HISTOGRAMS" '
+                re != "" && $1 !~ re { next }
+                hist != "true" && $2 ~ / == / { next }
+                { print label "\t" $1 "\t" $2 "\t" $3 "\t" $4 }'
+    done < "$STATS_LIST"
+}
+
+if $JSON; then
+    # One record per (file, function), counters grouped by pass
+    # Sum counters bumped by several instances of the same pass first
+    parse_stats | awk -F'\t' '{ n[$1 "\t" $4 "\t" $2 "\t" $3] += $5 }
+        END { for (k in n) print k "\t" n[k] }' |
+    sort -t$'\t' -k1,1 -k2,2 -k3,3 -k4,4 | awk -F'\t' '
+        function esc(s) { gsub(/\\/, "\\\\", s); gsub(/"/, "\\\"", s); return s }
+        function flush() {
+            if (key == "") return
+            printf "%s}}}\n", rec
+        }
+        {
+            k = $1 SUBSEP $2
+            if (k != key) {
+                flush()
+                key = k; pass = ""
+                rec = "{\"file\":\"" esc($1) "\",\"function\":\"" esc($2) "\",\"passes\":{"
+            }
+            if ($3 != pass) {
+                rec = rec (pass == "" ? "" : "},") "\"" esc($3) "\":{"
+                pass = $3; first = 1
+            }
+            rec = rec (first ? "" : ",") "\"" esc($4) "\":" $5
+            first = 0
+        }
+        END { flush() }'
+    # Cycle deltas as separate records: {"file","function","cycles":{flag:{...}}}
+    if $CYCLES; then
+        cycle_deltas | sort -t$'\t' -k1,1 -k3,3 -k2,2 | awk -F'\t' '
+            function esc(s) { gsub(/\\/, "\\\\", s); gsub(/"/, "\\\"", s); return s }
+            function flush() { if (key != "") printf "%s}}\n", rec }
+            {
+                k = $1 SUBSEP $3
+                if (k != key) {
+                    flush(); key = k; first = 1
+                    rec = "{\"file\":\"" esc($1) "\",\"function\":\"" esc($3) "\",\"cycles\":{"
+                }
+                rec = rec (first ? "" : ",") sprintf("\"%s\":{\"static\":%d,\"weighted\":%d,\"bytes\":%d}", esc($2), $4, $5, $6)
+                first = 0
+            }
+            END { flush() }'
+    fi
+    exit 0
+fi
+
+nfiles=$(wc -l < "$STATS_LIST")
+echo "Pass Statistics ($nfiles translation units)"
+echo "=================================================="
+echo ""
+printf "%-24s %-40s %8s %6s %6s\n" "Pass" "Counter" "Total" "Funcs" "Files"
+printf "%-24s %-40s %8s %6s %6s\n" "----" "-------" "-----" "-----" "-----"
+parse_stats | awk -F'\t' '
+    {
+        k = $2 "\t" $3
+        total[k] += $5
+        if (!((k, $1, $4) in seenf)) { seenf[k, $1, $4] = 1; funcs[k]++ }
+        if (!((k, $1) in seenu))     { seenu[k, $1] = 1; files[k]++ }
+    }
+    END { for (k in total) print total[k] "\t" k "\t" funcs[k] "\t" files[k] }' |
+    sort -t$'\t' -k1,1nr | head -n "$TOP" |
+    awk -F'\t' '{ printf "%-24s %-40s %8d %6d %6d\n", substr($2, 1, 24), substr($3, 1, 40), $1, $4, $5 }'
+
+if $CYCLES; then
+    DELTAS=$(cycle_deltas)
+    echo ""
+    echo "Estimated Cycle Deltas (68000, pass on minus pass off; negative = saves)"
+    echo "=================================================="
+    echo ""
+    printf "%-30s %10s %10s %8s %6s\n" "Flag" "Static" "Weighted" "Bytes" "Funcs"
+    printf "%-30s %10s %10s %8s %6s\n" "----" "------" "--------" "-----" "-----"
+    echo "$DELTAS" | awk -F'\t' 'NF == 6 { s[$2] += $4; w[$2] += $5; b[$2] += $6; n[$2]++ }
+        END { for (f in s) printf "%-30s %+10d %+10d %+8d %6d\n", f, s[f], w[f], b[f], n[f] }' |
+        sort -k3,3n
+    echo ""
+    printf "%-30s %-30s %10s %10s %8s\n" "Flag" "Function" "Static" "Weighted" "Bytes"
+    printf "%-30s %-30s %10s %10s %8s\n" "----" "--------" "------" "--------" "-----"
+    # Largest movers either way, by weighted delta
+    echo "$DELTAS" | awk -F'\t' 'NF == 6 { print ($5 < 0 ? -$5 : $5) "\t" $0 }' | sort -t$'\t' -k1,1nr |
+        head -n "$TOP" | awk -F'\t' '{ printf "%-30s %-30s %+10d %+10d %+8d\n", $3, substr($4, 1, 30), $5, $6, $7 }'
+fi
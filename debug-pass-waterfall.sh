@@ -0,0 +1,287 @@
+#!/bin/bash
+# Show how each pass changes a function's size and estimated cost
+# See GCC_DEBUG.md section 3 for background
+
+set -e
+
+# --- Defaults ---
+OPT_FLAGS="-Os -mshort -mfastcall"
+EXTRA_FLAGS=""
+FUNC=""
+SHOW_ALL=false
+GIMPLE=false
+SELF_CHECK=false
+
+XGCC="./build-host/gcc/xgcc"
+OUTDIR="./tmp/debug/waterfall"
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+
+# --- Colors (only if stdout is a terminal) ---
+if [ -t 1 ]; then
+    BOLD='\033[1m'
+    GREEN='\033[1;32m'
+    RED='\033[1;31m'
+    DIM='\033[2m'
+    RESET='\033[0m'
+else
+    BOLD="" GREEN="" RED="" DIM="" RESET=""
+fi
+
+usage() {
+    cat <<EOF
+Usage: $0 [options] <source.c>
+
+Compile with -fdump-rtl-all and print a waterfall of instruction count,
+memory references, auto-increment addresses, estimated bytes and
+estimated cycles after every RTL pass. Passes that appear to undo the most recent m68k or
+peephole2 transform are flagged.
+
+Options:
+  -f FUNC    Only function FUNC (default: whole file)
+  -O FLAGS   Optimization flags (default: $OPT_FLAGS)
+  -x FLAGS   Extra compiler flags
+  -g         Also include GIMPLE passes (statement counts only)
+  -a         Show every pass, not only passes that changed something
+  -T         Check the metrics against the tracked
+             hash_bytes.cc.345r.m68k-sink-postinc dump and exit
+  -h         Show this help
+
+Examples:
+  $0 -f my_func test.c
+  $0 -g -a -f my_func test.c
+  $0 -O "-O2" -x "-mcpu=68030" -f my_func test.c
+EOF
+    exit 1
+}
+
+# --- Parse args ---
+while getopts "f:O:x:gaTh" opt; do
+    case $opt in
+        f) FUNC="$OPTARG" ;;
+        O) OPT_FLAGS="$OPTARG" ;;
+        x) EXTRA_FLAGS="$OPTARG" ;;
+        g) GIMPLE=true ;;
+        a) SHOW_ALL=true ;;
+        T) SELF_CHECK=true ;;
+        h) usage ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+# --- Extract a function from a dump file (same as debug-dump-pass.sh) ---
+extract_func_from_dump() {
+    local file="$1"
+    local func="$2"
+    sed -n "/^;; Function ${func} /,/^;; Function /{ /^;; Function ${func} /p; /^;; Function [^(]/!p; }" "$file"
+}
+
+# --- Metrics for one dump: "insns mems autoinc bytes cycles" ---
+# RTL: insns are insn/jump_insn/call_insn; only their patterns are read,
+# not the REG_EQUAL/REG_EQUIV notes that follow or debug insns.
+# Bytes are a coarse m68k size: one opcode word per insn, plus extension
+# words for displaced/indexed (2) and absolute (4) memory addresses and
+# for constants outside the quick range (2, or 4 beyond 16 bits).
+# Cycles are a rough 68000 figure: 4 per instruction word fetched plus
+# 4 per word of memory data moved.
+# Some passes print the insn chain more than once per function; only the
+# last chain (starting at the insn with no predecessor) is counted.
+# GIMPLE: statements after the first basic block label; other columns "-".
+rtl_metrics() {
+    awk '
+        function reset() { insns = mems = autoinc = cyc = ext = 0 }
+        function add() { ti += insns; tm += mems; ta += autoinc; tc += cyc; te += ext; reset() }
+        /^;; Function / { add(); in_pat = 0; next }
+        /^\((note|insn|code_label|barrier)[\/:a-zA-Z]* [0-9]+ 0 / { reset() }
+        /^\(/ { in_pat = ($0 ~ /^\((insn|jump_insn|call_insn)[ \/:]/); if (in_pat) insns++ }
+        in_pat {
+            line = $0
+            # The note list ends the insn; nothing after it is pattern
+            if (match(line, /\((expr_list|insn_list|int_list):REG_/)) {
+                line = substr(line, 1, RSTART - 1); in_pat = 0
+            }
+            pat = line
+            while (match(line, /\(mem[\/a-z]*:[A-Z]+( |$)/)) {
+                mode = substr(line, RSTART, RLENGTH); sub(/ $/, "", mode); sub(/.*:/, "", mode)
+                mems++
+                cyc += (mode == "QI" || mode == "HI") ? 4 : (mode == "DI" || mode == "DF") ? 16 : (mode == "XF") ? 24 : 8
+                line = substr(line, RSTART + RLENGTH)
+                if (line ~ /^\((symbol_ref|const|label_ref)/) ext += 4
+                else if (line ~ /^\(plus/) ext += 2
+            }
+            line = pat
+            autoinc += gsub(/\((post_inc|pre_dec|post_dec|pre_inc|post_modify|pre_modify):/, "", line)
+            line = pat
+            # Dumps print "(const_int 8 [0x8])"; the decimal comes first
+            while (match(line, /\(const_int -?[0-9]+[ )]/)) {
+                split(substr(line, RSTART + 11), a, /[ )]/)
+                v = a[1] + 0
+                if (v < 0) v = -v
+                if (v > 127) ext += (v > 32767) ? 4 : 2
+                line = substr(line, RSTART + RLENGTH)
+            }
+        }
+        END { add(); print ti + 0, tm + 0, ta + 0, ti * 2 + te, ti * 4 + te * 2 + tc }'
+}
+
+gimple_metrics() {
+    awk '
+        /^ *<bb [0-9]+>/ { inbody = 1; next }
+        inbody && /;$/ && !/^ *#/ { stmts++ }
+        END { print stmts + 0, "-", "-", "-", "-" }'
+}
+
+# --- Self-check on the tracked dump ---
+# std::_Hash_bytes has five 4-byte 0x5bd1e995 immediates in its patterns
+# and 16 auto-increment addresses; update EXPECT only when the estimate
+# itself is changed on purpose.
+if $SELF_CHECK; then
+    dump="$SCRIPT_DIR/hash_bytes.cc.345r.m68k-sink-postinc"
+    EXPECT="98 59 16 278 964"
+    got=$(extract_func_from_dump "$dump" "std::_Hash_bytes" | rtl_metrics)
+    if [ "$got" != "$EXPECT" ]; then
+        echo "FAIL: std::_Hash_bytes metrics are '$got', expected '$EXPECT'"
+        echo "      (insns mems autoinc bytes cycles)"
+        exit 1
+    fi
+    echo "OK: std::_Hash_bytes metrics $got"
+    exit 0
+fi
+
+SOURCE="${1:-}"
+if [ -z "$SOURCE" ]; then
+    echo "Error: no source file specified"
+    usage
+fi
+
+if [ ! -f "$SOURCE" ]; then
+    echo "Error: $SOURCE not found"
+    exit 1
+fi
+
+if [ ! -f "$XGCC" ]; then
+    echo "Error: $XGCC not found — run ./build-gcc.sh build first"
+    exit 1
+fi
+
+# --- Setup ---
+rm -rf "$OUTDIR"
+mkdir -p "$OUTDIR"
+SRCBASE=$(basename "$SOURCE")
+FLAGS="$OPT_FLAGS $EXTRA_FLAGS -fno-inline"
+DUMP_FLAGS="-fdump-rtl-all"
+$GIMPLE && DUMP_FLAGS="$DUMP_FLAGS -fdump-tree-all"
+
+echo -e "${BOLD}Source:${RESET} $SOURCE"
+echo -e "${BOLD}Flags:${RESET}  $FLAGS"
+[ -n "$FUNC" ] && echo -e "${BOLD}Function:${RESET} $FUNC"
+echo ""
+
+# shellcheck disable=SC2086
+"$XGCC" -B./build-host/gcc $FLAGS $DUMP_FLAGS -dumpdir "${OUTDIR}/" -S "$SOURCE" -o /dev/null
+
+# Delta column: empty for the first row of an IL and for "-" values
+fmt_d() {
+    if [ "$1" = "-" ] || $is_first; then echo ""; else printf "%+d" "$1"; fi
+}
+
+# --- Collect dumps in pass order ---
+# Dump names are <src>.<NNN><r|t>.<pass>; NNN is the pass number.
+DUMPS=$(ls -1 "$OUTDIR/${SRCBASE}."*[0-9][rt].* 2>/dev/null |
+    sed -E "s|^(.*\.([0-9]+)([rt])\.(.*))$|\2\t\3\t\4\t\1|" | sort -t$'\t' -k1,1n)
+
+if [ -z "$DUMPS" ]; then
+    echo "Error: no dump files produced in $OUTDIR"
+    exit 1
+fi
+
+# --- Waterfall ---
+printf "%-26s %6s %5s %6s %5s %6s %5s %6s %5s %7s %6s  %s\n" "Pass" "Insns" "Δ" "Mems" "Δ" "AutoInc" "Δ" "Bytes" "Δ" "Cycles" "Δ" ""
+printf "%-26s %6s %5s %6s %5s %6s %5s %6s %5s %7s %6s  %s\n" "----" "-----" "-" "----" "-" "-------" "-" "-----" "-" "------" "-" ""
+
+prev_kind=""
+prev_i=0 prev_m=0 prev_a=0 prev_b=0 prev_c=0
+# Most recent m68k/peephole2 change, to spot passes that undo it
+guard_pass="" guard_di=0 guard_da=0
+changed=0 flagged=0 undo_pair=""
+
+while IFS=$'\t' read -r num kind pass file; do
+    if [ -n "$FUNC" ]; then
+        body=$(extract_func_from_dump "$file" "$FUNC")
+    else
+        body=$(cat "$file")
+    fi
+    # Pass did not run on this function (or produced an empty dump)
+    if ! echo "$body" | grep -qE '^(\((insn|jump_insn|call_insn|note)[ /:]| *<bb [0-9]+>)'; then
+        continue
+    fi
+
+    if [ "$kind" = "r" ]; then
+        read -r i m a b c <<< "$(echo "$body" | rtl_metrics)"
+    else
+        read -r i m a b c <<< "$(echo "$body" | gimple_metrics)"
+    fi
+
+    # Deltas only within the same IL (GIMPLE statements vs RTL insns differ)
+    if [ "$kind" != "$prev_kind" ]; then
+        di=0 dm=0 da=0 db=0 dc=0
+        [ -n "$prev_kind" ] && echo -e "${DIM}-- expand to RTL --${RESET}"
+        is_first=true
+    else
+        di=$((i - prev_i))
+        if [ "$kind" = "r" ]; then
+            dm=$((m - prev_m)) da=$((a - prev_a)) db=$((b - prev_b)) dc=$((c - prev_c))
+        else
+            dm=0 da=0 db=0 dc=0
+        fi
+        is_first=false
+    fi
+
+    note=""
+    if [ "$kind" = "r" ] && ! $is_first; then
+        # A later pass exactly reverses the insn delta, or drops auto-increments
+        # that the guarded pass added: likely undoing its work.
+        if [ -n "$guard_pass" ] && [[ "$pass" != m68k-* ]] && [ "$pass" != "peephole2" ]; then
+            if { [ "$guard_di" -ne 0 ] && [ "$di" -eq $((-guard_di)) ]; } ||
+               { [ "$guard_da" -gt 0 ] && [ "$da" -lt 0 ]; }; then
+                note="${RED}undoes ${guard_pass}?${RESET}"
+                flagged=$((flagged + 1))
+                undo_pair="$guard_pass $pass"
+                guard_pass=""
+            fi
+        fi
+        if [[ "$pass" == m68k-* || "$pass" == "peephole2" ]] && { [ "$di" -ne 0 ] || [ "$da" -ne 0 ] || [ "$dc" -ne 0 ]; }; then
+            guard_pass="$pass" guard_di=$di guard_da=$da
+        fi
+    fi
+
+    if [ "$di" -ne 0 ] || [ "$dm" -ne 0 ] || [ "$da" -ne 0 ] || [ "$db" -ne 0 ] || [ "$dc" -ne 0 ]; then
+        changed=$((changed + 1))
+    fi
+
+    if $SHOW_ALL || $is_first || [ "$di" -ne 0 ] || [ "$dm" -ne 0 ] || [ "$da" -ne 0 ] || [ "$db" -ne 0 ] || [ "$dc" -ne 0 ] || [ -n "$note" ]; then
+        # Bar: one character per 4 estimated cycles (or per statement for GIMPLE)
+        delta=$dc
+        [ "$kind" = "t" ] && delta=$di
+        bar=""
+        if [ "$delta" -gt 0 ]; then
+            bar="${RED}$(printf '%*s' $(( (delta + 3) / 4 > 20 ? 20 : (delta + 3) / 4 )) '' | tr ' ' '+')${RESET}"
+        elif [ "$delta" -lt 0 ]; then
+            bar="${GREEN}$(printf '%*s' $(( (-delta + 3) / 4 > 20 ? 20 : (-delta + 3) / 4 )) '' | tr ' ' '-')${RESET}"
+        fi
+        printf "%-26s %6s %5s %6s %5s %6s %5s %6s %5s %7s %6s  " \
+            "$num$kind.$pass" "$i" "$(fmt_d $di)" "$m" "$( [ "$kind" = "r" ] && fmt_d $dm)" \
+            "$a" "$( [ "$kind" = "r" ] && fmt_d $da)" "$b" "$( [ "$kind" = "r" ] && fmt_d $db)" \
+            "$c" "$( [ "$kind" = "r" ] && fmt_d $dc)"
+        echo -e "$bar${note:+ $note}"
+    fi
+
+    prev_kind="$kind" prev_i=$i prev_m=$m prev_a=$a prev_b=$b prev_c=$c
+done <<< "$DUMPS"
+
+echo ""
+echo -e "${BOLD}Passes with changes:${RESET} $changed"
+if [ "$flagged" -gt 0 ]; then
+    echo -e "${BOLD}Possible undo:${RESET} $flagged (check with ./debug-dump-pass.sh${FUNC:+ -f $FUNC} $SOURCE $undo_pair)"
+fi
+echo -e "${DIM}Dumps: $OUTDIR/${RESET}"
@@ -0,0 +1,318 @@
+#!/bin/bash
+# Record per-function metrics of test_cases.cpp per GCC commit and compare
+# them against earlier commits or a pinned baseline
+# See GCC_DEBUG.md section 1 for background
+
+set -e
+
+# --- Defaults ---
+SRCDIR="$HOME/m68k-atari-mint-gcc"
+HISTORY_DIR="./perf-history"
+INPUT_DIR="./tmp/test_cases"
+ANNOTATE="./debug-annotate-cycles.sh"
+METRIC="cycles"
+THRESHOLD=2
+MIN_DELTA=2
+TOP=15
+VARIANT_RE=""
+TAG=""
+
+usage() {
+    cat <<EOF
+Usage: $0 <command> [options]
+
+Keep a history of per-function metrics for the assembly produced by
+./build-test_cases.sh, one CSV per GCC commit in $HISTORY_DIR/.
+
+Commands:
+  record [-c TAG]         Record tmp/test_cases/*_{new,reload}.s under the
+                          current GCC commit (or TAG)
+  compare [REF] [CUR]     Diff CUR (default: latest) against REF (default:
+                          pinned baseline, else the previous record)
+  list                    Show recorded commits with totals
+  pin [REF]               Pin REF (default: latest) as the baseline
+
+Compare options:
+  -m METRIC  cycles, size, insns or compile_ms (default: $METRIC)
+  -t PCT     Regression threshold in percent (default: $THRESHOLD)
+  -a N       Ignore changes smaller than N units (default: $MIN_DELTA)
+  -n N       Show the N worst and best movers (default: $TOP)
+  -v REGEX   Only variants matching REGEX (e.g. 'Os_short|68030')
+
+REF/CUR are commit ids (or prefixes) as shown by "list", or "baseline".
+compare exits with status 1 when a function regresses beyond the threshold.
+
+Columns: cycles = clccnt max cycles, or the 68000 static estimate when
+clccnt is missing (empty for other CPUs); size = estimated bytes;
+insns = instruction count; compile_ms = variant compile time (row "*").
+
+Examples:
+  ./build-test_cases.sh -record
+  $0 compare
+  $0 compare -m size -t 1 baseline
+  $0 pin a1b2c3d
+EOF
+    exit 1
+}
+
+COMMAND="${1:-}"
+[ -n "$COMMAND" ] || usage
+shift
+
+# --- Parse args ---
+while getopts "c:m:t:a:n:v:h" opt; do
+    case $opt in
+        c) TAG="$OPTARG" ;;
+        m) METRIC="$OPTARG" ;;
+        t) THRESHOLD="$OPTARG" ;;
+        a) MIN_DELTA="$OPTARG" ;;
+        n) TOP="$OPTARG" ;;
+        v) VARIANT_RE="$OPTARG" ;;
+        h) usage ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+case "$METRIC" in
+    cycles|size|insns|compile_ms) ;;
+    *) echo "Error: unknown metric '$METRIC'"; usage ;;
+esac
+
+CLCCNT=$(command -v clccnt 2>/dev/null || true)
+CSV_HEADER="commit,date,variant,compiler,function,cycles,size,insns,compile_ms"
+
+# clccnt CPU model for a variant suffix (as in build-test_cases.sh)
+cpu_for_variant() {
+    case "$1" in
+        *_68030) echo "030" ;;
+        *_68040) echo "040" ;;
+        *_68060) echo "060" ;;
+        *_cf)    echo "060" ;;
+        *)       echo "000" ;;
+    esac
+}
+
+# "function insns" for every function in a .s file
+function_insns() {
+    awk '/^[A-Za-z_][A-Za-z0-9_.$]*:/ { f = substr($0, 1, length($0) - 1); n[f] += 0; next }
+         /^\t\.size/ { f = "" }
+         /^\t[a-z]/ && f != "" { n[f]++ }
+         END { for (k in n) print k, n[k] }' "$1"
+}
+
+# "function cycles" (clccnt max, or 68000 estimate)
+function_cycles() {
+    local file="$1" cpu="$2"
+    if [ -n "$CLCCNT" ]; then
+        "$CLCCNT" -c "$cpu" "$file" 2>/dev/null | awk '{n=split($NF,a,"-"); print $1, (n>1 ? a[2] : a[1])}'
+    elif [ "$cpu" = "000" ] && [ -x "$ANNOTATE" ]; then
+        "$ANNOTATE" -s -c 000 "$file" | awk '{print $1, $2}'
+    fi
+}
+
+# "function bytes" from the annotator's encoding sizes (not for ColdFire)
+function_sizes() {
+    local file="$1" suffix="$2"
+    case "$suffix" in *_cf) return ;; esac
+    [ -x "$ANNOTATE" ] && "$ANNOTATE" -s -c 000 "$file" | awk '{print $1, $4}'
+}
+
+gcc_commit() {
+    local c
+    if ! c=$(git -C "$SRCDIR" rev-parse --short=10 HEAD 2>/dev/null); then
+        echo "Error: $SRCDIR is not a git checkout — use -c TAG" >&2
+        exit 1
+    fi
+    if ! git -C "$SRCDIR" diff --quiet HEAD -- gcc 2>/dev/null; then
+        c="$c-dirty"
+    fi
+    echo "$c"
+}
+
+# Resolve a commit id, prefix or "baseline" to a CSV file
+resolve() {
+    local ref="$1" f
+    if [ "$ref" = "baseline" ]; then
+        [ -f "$HISTORY_DIR/baseline" ] || { echo "Error: no baseline pinned" >&2; exit 1; }
+        ref=$(cat "$HISTORY_DIR/baseline")
+    fi
+    if [ -f "$HISTORY_DIR/$ref.csv" ]; then
+        echo "$HISTORY_DIR/$ref.csv"
+        return
+    fi
+    f=$(ls "$HISTORY_DIR/$ref"*.csv 2>/dev/null || true)
+    if [ -z "$f" ] || [ "$(echo "$f" | wc -l)" -ne 1 ]; then
+        echo "Error: '$ref' does not match exactly one record in $HISTORY_DIR/" >&2
+        exit 1
+    fi
+    echo "$f"
+}
+
+# Records ordered by recording time, oldest first
+records() {
+    ls -tr "$HISTORY_DIR"/*.csv 2>/dev/null || true
+}
+
+do_record() {
+    local commit="$TAG" date out tmp
+    [ -n "$commit" ] || commit=$(gcc_commit)
+    date=$(date +%Y-%m-%dT%H:%M:%S)
+    mkdir -p "$HISTORY_DIR"
+    out="$HISTORY_DIR/$commit.csv"
+    tmp="$out.tmp"
+    echo "$CSV_HEADER" > "$tmp"
+
+    local files=("$INPUT_DIR"/*_new.s "$INPUT_DIR"/*_reload.s)
+    local file n=0
+    for file in "${files[@]}"; do
+        [ -f "$file" ] || continue
+        local base suffix compiler cpu ms=""
+        base=$(basename "$file" .s)
+        compiler="${base##*_}"
+        suffix="${base%_*}"
+        cpu=$(cpu_for_variant "$suffix")
+
+        # Compile time, when build-test_cases.sh actually compiled it
+        local times="$INPUT_DIR/.jobs/times/$base.s"
+        if [ -f "$times" ] && [ "$(awk '{print $2}' "$times")" = "compiled" ]; then
+            ms=$(awk '{print $3}' "$times")
+        fi
+
+        awk -v commit="$commit" -v date="$date" -v var="$suffix" -v cc="$compiler" -v ms="$ms" '
+            FILENAME == ARGV[1] { cyc[$1] = $2; next }
+            FILENAME == ARGV[2] { size[$1] = $2; next }
+            { print commit "," date "," var "," cc "," $1 "," cyc[$1] "," size[$1] "," $2 "," }
+            END { print commit "," date "," var "," cc ",*,,,," ms }
+        ' <(function_cycles "$file" "$cpu") <(function_sizes "$file" "$suffix") <(function_insns "$file" | sort) >> "$tmp"
+        n=$((n + 1))
+    done
+
+    if [ "$n" -eq 0 ]; then
+        rm -f "$tmp"
+        echo "Error: no $INPUT_DIR/*_new.s files — run ./build-test_cases.sh first"
+        exit 1
+    fi
+    mv -f "$tmp" "$out"
+    echo "Recorded $n variants, $(($(wc -l < "$out") - 1 - n)) functions as $commit ($out)"
+}
+
+do_list() {
+    local baseline=""
+    [ -f "$HISTORY_DIR/baseline" ] && baseline=$(cat "$HISTORY_DIR/baseline")
+    printf "%-18s %-20s %6s %10s %10s %10s\n" "Commit" "Recorded" "Funcs" "Cycles" "Size" "Insns"
+    printf "%-18s %-20s %6s %10s %10s %10s\n" "------" "--------" "-----" "------" "----" "-----"
+    local f
+    for f in $(records); do
+        local commit
+        commit=$(basename "$f" .csv)
+        awk -F, -v c="$commit" -v pin="$baseline" '
+            NR == 1 || $5 == "*" { next }
+            { d = $2; n++; cy += $6; sz += $7; in_ += $8 }
+            END { printf "%-18s %-20s %6d %10d %10d %10d\n", c (c == pin ? " (base)" : ""), d, n, cy, sz, in_ }' "$f"
+    done
+}
+
+do_pin() {
+    local ref="${1:-}" f
+    if [ -z "$ref" ]; then
+        f=$(records | tail -1)
+        [ -n "$f" ] || { echo "Error: nothing recorded yet"; exit 1; }
+    else
+        f=$(resolve "$ref")
+    fi
+    basename "$f" .csv > "$HISTORY_DIR/baseline"
+    echo "Baseline: $(cat "$HISTORY_DIR/baseline")"
+}
+
+do_compare() {
+    local ref_file cur_file
+    if [ $# -ge 2 ]; then
+        cur_file=$(resolve "$2")
+    else
+        cur_file=$(records | tail -1)
+        [ -n "$cur_file" ] || { echo "Error: nothing recorded yet"; exit 1; }
+    fi
+    if [ $# -ge 1 ]; then
+        ref_file=$(resolve "$1")
+    elif [ -f "$HISTORY_DIR/baseline" ]; then
+        ref_file=$(resolve baseline)
+    else
+        ref_file=$(records | grep -vxF "$cur_file" | tail -1)
+        [ -n "$ref_file" ] || { echo "Error: need two records (or a pinned baseline) to compare"; exit 1; }
+    fi
+
+    local col
+    case "$METRIC" in
+        cycles) col=6 ;; size) col=7 ;; insns) col=8 ;; compile_ms) col=9 ;;
+    esac
+
+    echo "Comparing $(basename "$cur_file" .csv) against $(basename "$ref_file" .csv) ($METRIC, threshold ${THRESHOLD}%, min delta $MIN_DELTA)"
+    echo ""
+
+    awk -F, -v col="$col" -v thr="$THRESHOLD" -v mind="$MIN_DELTA" -v top="$TOP" -v vre="$VARIANT_RE" '
+        function key() { return $3 SUBSEP $4 SUBSEP $5 }
+        FNR == 1 { next }
+        vre != "" && $3 !~ vre { next }
+        (col == 9) != ($5 == "*") { next }
+        FILENAME == ARGV[1] { if ($col != "") ref[key()] = $col; next }
+        {
+            k = key()
+            if ($col == "") next
+            if (!(k in ref)) { added++; next }
+            seen[k] = 1
+            var = $3 " " $4
+            r = ref[k] + 0; c = $col + 0
+            tr[var] += r; tc[var] += c; vars[var] = 1
+            d = c - r
+            if (d < mind && -d < mind) next
+            p = r > 0 ? d * 100 / r : 100
+            if (p > thr) { reg[var]++; nreg++; mv[++m] = p; mk[m] = k; md[m] = d; mr[m] = r; mc[m] = c }
+            else if (p < -thr) { imp[var]++; mv[++m] = p; mk[m] = k; md[m] = d; mr[m] = r; mc[m] = c }
+        }
+        END {
+            for (k in ref) if (!(k in seen)) removed++
+            printf "%-24s %10s %10s %7s %6s %6s\n", "Variant", "Ref", "Cur", "Diff%", "Regr", "Impr"
+            printf "%-24s %10s %10s %7s %6s %6s\n", "-------", "---", "---", "-----", "----", "----"
+            nv = 0
+            for (v in vars) names[++nv] = v
+            for (i = 1; i <= nv; i++) for (j = i + 1; j <= nv; j++) if (names[j] < names[i]) { t = names[i]; names[i] = names[j]; names[j] = t }
+            for (i = 1; i <= nv; i++) {
+                v = names[i]
+                printf "%-24s %10d %10d %6.1f%% %6d %6d\n", v, tr[v], tc[v], (tr[v] > 0 ? (tc[v] - tr[v]) * 100 / tr[v] : 0), reg[v], imp[v]
+            }
+            printf "\n%d functions added, %d removed since the reference\n", added, removed
+
+            # Order movers by percentage (insertion sort; lists are short)
+            for (i = 2; i <= m; i++) {
+                p = mv[i]; k = mk[i]; d = md[i]; r = mr[i]; c = mc[i]
+                for (j = i - 1; j >= 1 && mv[j] < p; j--) { mv[j+1] = mv[j]; mk[j+1] = mk[j]; md[j+1] = md[j]; mr[j+1] = mr[j]; mc[j+1] = mc[j] }
+                mv[j+1] = p; mk[j+1] = k; md[j+1] = d; mr[j+1] = r; mc[j+1] = c
+            }
+            hdr = "%-40s %-16s %8s %8s %8s\n"
+            if (m > 0 && mv[1] > thr) {
+                printf "\nWorst movers\n\n" hdr, "Function", "Variant", "Ref", "Cur", "Diff%"
+                for (i = 1; i <= m && i <= top && mv[i] > thr; i++) {
+                    split(mk[i], f, SUBSEP)
+                    printf "%-40s %-16s %8d %8d %+7.1f%%\n", f[3], f[1] " " f[2], mr[i], mc[i], mv[i]
+                }
+            }
+            if (m > 0 && mv[m] < -thr) {
+                printf "\nBest movers\n\n" hdr, "Function", "Variant", "Ref", "Cur", "Diff%"
+                for (i = m; i >= 1 && i > m - top && mv[i] < -thr; i--) {
+                    split(mk[i], f, SUBSEP)
+                    printf "%-40s %-16s %8d %8d %+7.1f%%\n", f[3], f[1] " " f[2], mr[i], mc[i], mv[i]
+                }
+            }
+            exit nreg > 0
+        }
+    ' "$ref_file" "$cur_file"
+}
+
+case "$COMMAND" in
+    record)  do_record ;;
+    compare) do_compare "$@" ;;
+    list)    do_list ;;
+    pin)     do_pin "$@" ;;
+    *)       usage ;;
+esac
@@ -0,0 +1,247 @@
+#!/bin/bash
+# Reduce a source file while a function stays slower with the new compiler
+# See GCC_DEBUG.md section 4 for background
+
+set -e
+
+# --- Defaults ---
+OPT_FLAGS="-Os -mshort -mfastcall"
+EXTRA_FLAGS=""
+FUNC=""
+METRIC="weighted"
+MIN_DELTA=""
+CC_OLD="m68k-atari-mintelf-gcc"
+CC_NEW="./build-host/gcc/xgcc -B./build-host/gcc"
+REDUCER=""
+PREPROCESS=true
+CXX_CHECK=true
+JOBS=$(sysctl -n hw.ncpu 2>/dev/null || nproc 2>/dev/null || echo 4)
+
+OUTDIR="./tmp/reduce"
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+ANNOTATE="$SCRIPT_DIR/debug-annotate-cycles.sh"
+
+# Warnings that usually mean the reducer introduced undefined behaviour
+BAD_WARNINGS="uninitialized|no return statement|control reaches end|implicit declaration|implicit-int|incompatible pointer|makes (pointer|integer) from|array subscript|division by zero|shift count|undefined behavior|-Wreturn-type|-Waggressive-loop"
+
+usage() {
+    cat <<EOF
+Usage: $0 [options] -f FUNC <source.c>
+
+Shrink <source.c> with cvise or creduce while FUNC stays at least N units
+worse with the new compiler than with the old one, and the file still
+compiles cleanly. Writes a reproducer ready to paste into test_cases.cpp.
+
+Options:
+  -f FUNC    Function to keep (assembler name; required)
+  -O FLAGS   Optimization flags (default: $OPT_FLAGS)
+  -x FLAGS   Extra compiler flags
+  -m METRIC  weighted, static (68000 cycles), bytes or insns
+             (default: $METRIC)
+  -n N       Minimum regression to keep (default: half the initial one)
+  -old CC    Old compiler (default: $CC_OLD)
+  -new CC    New compiler (default: $CC_NEW)
+  -r TOOL    cvise or creduce (default: whichever is installed)
+  -j N       Reducer jobs (default: $JOBS)
+  -nopp      Do not preprocess the source first
+  -nocxx     Do not require the result to compile as C++ in extern "C"
+  -h         Show this help
+
+Examples:
+  $0 -f deflate_slow zlib/deflate.c
+  $0 -f test_copy -O "-O2 -mfastcall" -m insns test_cases.cpp
+  $0 -f dct64 -n 40 -x "-I mpg123/src" mpg123/src/libmpg123/dct64.c
+EOF
+    exit 1
+}
+
+# --- Parse args ---
+# Manual parsing to support multi-char flags
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -f)      FUNC="$2"; shift 2 ;;
+        -O)      OPT_FLAGS="$2"; shift 2 ;;
+        -x)      EXTRA_FLAGS="$2"; shift 2 ;;
+        -m)      METRIC="$2"; shift 2 ;;
+        -n)      MIN_DELTA="$2"; shift 2 ;;
+        -old)    CC_OLD="$2"; shift 2 ;;
+        -new)    CC_NEW="$2"; shift 2 ;;
+        -r)      REDUCER="$2"; shift 2 ;;
+        -j)      JOBS="$2"; shift 2 ;;
+        -nopp)   PREPROCESS=false; shift ;;
+        -nocxx)  CXX_CHECK=false; shift ;;
+        -h)      usage ;;
+        -*)      echo "Unknown option: $1"; usage ;;
+        *)       break ;;
+    esac
+done
+
+SOURCE="${1:-}"
+if [ -z "$SOURCE" ] || [ -z "$FUNC" ]; then
+    echo "Error: need -f FUNC and a source file"
+    usage
+fi
+if [ ! -f "$SOURCE" ]; then
+    echo "Error: $SOURCE not found"
+    exit 1
+fi
+case "$METRIC" in
+    weighted|static|bytes|insns) ;;
+    *) echo "Error: unknown metric '$METRIC'"; usage ;;
+esac
+if [ -z "$REDUCER" ]; then
+    REDUCER=$(command -v cvise 2>/dev/null || command -v creduce 2>/dev/null || true)
+    [ -n "$REDUCER" ] || { echo "Error: neither cvise nor creduce found on PATH"; exit 1; }
+fi
+
+# Compilers may be relative to the build dir; the reducer runs elsewhere
+abs_cc() {
+    local cc="$1" first rest
+    first="${cc%% *}" rest=""
+    [ "$first" != "$cc" ] && rest=" ${cc#* }"
+    if [[ "$first" == */* ]]; then
+        first="$(cd "$(dirname "$first")" && pwd)/$(basename "$first")"
+    fi
+    # -B./dir style options
+    echo "$first$rest" | sed "s| -B\./| -B$(pwd)/|g"
+}
+CC_OLD=$(abs_cc "$CC_OLD")
+CC_NEW=$(abs_cc "$CC_NEW")
+FLAGS="$OPT_FLAGS $EXTRA_FLAGS -fno-inline"
+
+# --- Setup ---
+WORK="$OUTDIR/$FUNC"
+mkdir -p "$WORK"
+WORK=$(cd "$WORK" && pwd)
+EXT="${SOURCE##*.}"
+case "$EXT" in
+    cpp|cc|cxx) LANG_FLAG="-x c++"; EXT=cpp; CXX_CHECK=false ;;
+    *)          LANG_FLAG="-x c"; EXT=c ;;
+esac
+FILE="reduce.$EXT"
+
+if $PREPROCESS; then
+    # shellcheck disable=SC2086
+    $CC_NEW $FLAGS $LANG_FLAG -E -P "$SOURCE" -o "$WORK/$FILE"
+else
+    cp "$SOURCE" "$WORK/$FILE"
+fi
+cp "$WORK/$FILE" "$WORK/original.$EXT"
+
+# Plain C that does not even start out as valid C++ cannot end up there
+if $CXX_CHECK; then
+    printf 'extern "C" {\n#include "%s"\n}\n' "$FILE" > "$WORK/wrap.cpp"
+    # shellcheck disable=SC2086
+    if ! (cd "$WORK" && $CC_NEW $FLAGS -x c++ -fsyntax-only wrap.cpp 2>/dev/null); then
+        echo "Note: $SOURCE does not compile as C++; not requiring a C++-clean result"
+        CXX_CHECK=false
+    fi
+fi
+
+# --- Interestingness test (runs in the reducer's scratch directory) ---
+cat > "$WORK/interesting.sh" <<EOF
+#!/bin/bash
+# Generated by debug-reduce-perf.sh: $FUNC must stay >= MIN_DELTA worse
+MIN_DELTA=1
+
+metric() {
+    case "$METRIC" in
+        insns)
+            awk -v f="$FUNC" '\$0 == f ":" { on = 1; next }
+                 on && /^\t\.size/ { exit }
+                 on && /^\t[a-z]/ { n++ }
+                 END { if (on) print n + 0 }' "\$1" ;;
+        *)
+            "$ANNOTATE" -s "\$1" | awk -v f="$FUNC" -v col="$METRIC" '
+                \$1 == f { print (col == "static" ? \$2 : col == "weighted" ? \$3 : \$4) }' ;;
+    esac
+}
+
+# Clean compile with the new compiler, without warnings that hint at UB
+$CC_NEW $FLAGS $LANG_FLAG -Wall -Wextra -S $FILE -o new.s 2> new.err || exit 1
+grep -qE "$BAD_WARNINGS" new.err && exit 1
+$CC_OLD $FLAGS $LANG_FLAG -S $FILE -o old.s 2> /dev/null || exit 1
+EOF
+if $CXX_CHECK; then
+    cat >> "$WORK/interesting.sh" <<EOF
+
+# Must also build inside test_cases.cpp's extern "C" block
+printf 'extern "C" {\\n#include "$FILE"\\n}\\n' > wrap.cpp
+$CC_NEW $FLAGS -x c++ -fsyntax-only wrap.cpp 2> /dev/null || exit 1
+EOF
+fi
+cat >> "$WORK/interesting.sh" <<'EOF'
+
+old=$(metric old.s)
+new=$(metric new.s)
+[ -n "$old" ] && [ -n "$new" ] || exit 1
+[ $((new - old)) -ge "$MIN_DELTA" ]
+EOF
+chmod +x "$WORK/interesting.sh"
+
+# --- Measure in a scratch copy ---
+# Prints "old new" for a candidate file
+measure() {
+    local dir="$WORK/measure"
+    rm -rf "${dir:?}"
+    mkdir -p "$dir"
+    cp "$1" "$dir/$FILE"
+    (
+        cd "$dir"
+        # shellcheck disable=SC2086
+        $CC_NEW $FLAGS $LANG_FLAG -S "$FILE" -o new.s 2>/dev/null || true
+        # shellcheck disable=SC2086
+        $CC_OLD $FLAGS $LANG_FLAG -S "$FILE" -o old.s 2>/dev/null || true
+        # Reuse the metric() definition from the generated test
+        eval "$(sed -n '/^metric() {/,/^}/p' "$WORK/interesting.sh")"
+        local old="" new=""
+        [ -f old.s ] && old=$(metric old.s)
+        [ -f new.s ] && new=$(metric new.s)
+        echo "${old:--} ${new:--}"
+    )
+}
+
+read -r old_start new_start <<< "$(measure "$WORK/$FILE")"
+if [ "$old_start" = - ] || [ "$new_start" = - ]; then
+    echo "Error: $FUNC not found in the output of both compilers (check -f, -O and -x)"
+    exit 1
+fi
+delta=$((new_start - old_start))
+if [ "$delta" -le 0 ]; then
+    echo "Error: $FUNC is not worse with the new compiler ($METRIC: old $old_start, new $new_start)"
+    exit 1
+fi
+[ -n "$MIN_DELTA" ] || MIN_DELTA=$(( (delta + 1) / 2 ))
+perl -pi -e "s/^MIN_DELTA=.*/MIN_DELTA=$MIN_DELTA/" "$WORK/interesting.sh"
+
+echo "Function: $FUNC ($METRIC: old $old_start, new $new_start, +$delta)"
+echo "Keeping:  at least +$MIN_DELTA"
+echo "Reducer:  $REDUCER ($JOBS jobs) in $WORK"
+echo ""
+
+if ! (cd "$WORK" && ./interesting.sh); then
+    echo "Error: the unreduced file fails the test; see $WORK/new.err"
+    echo "(the new compiler may warn about something in $BAD_WARNINGS)"
+    exit 1
+fi
+
+lines_before=$(wc -l < "$WORK/$FILE")
+(cd "$WORK" && "$REDUCER" --n "$JOBS" ./interesting.sh "$FILE")
+lines_after=$(wc -l < "$WORK/$FILE")
+
+# --- Reproducer for test_cases.cpp ---
+read -r old_end new_end <<< "$(measure "$WORK/$FILE")"
+NAME="$FUNC"
+[[ "$NAME" == test_* ]] || NAME="test_$FUNC"
+REPRO="$WORK/$NAME.txt"
+{
+    echo "    /* $NAME - reduced from $(basename "$SOURCE") ($OPT_FLAGS)"
+    echo "     * Regression: $METRIC $old_end (old) -> $new_end (new)"
+    echo "     */"
+    perl -pe "s/\\b\Q$FUNC\E\\b/$NAME/g; s/^(?=.)/    /" "$WORK/$FILE"
+} > "$REPRO"
+
+echo ""
+echo "Reduced $lines_before -> $lines_after lines; $METRIC old $old_end, new $new_end (+$((new_end - old_end)))"
+echo "Reproducer: $REPRO"
+echo "Paste it into the extern \"C\" block of test_cases.cpp, then run ./build-test_cases.sh"
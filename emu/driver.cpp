@@ -0,0 +1,136 @@
+/* Emulator driver for test_cases.cpp.
+ *
+ * Calls every test function once with generated arguments and reports the
+ * cycles between the marker stores around the call, plus a checksum of the
+ * return value and of the argument arena, through run68k's registers.
+ *
+ * Arguments are chosen from the parameter types:
+ *   integers, floats, enums   small constants (emu_ints[position])
+ *   pointers, references      a 2 KB region of the arena per position
+ *   trivial structs by value  value-initialized
+ * Anything else makes the test "skip", including function pointers: the
+ * arena holds data, and calling into it would run garbage.
+ *
+ * Each call goes through a volatile function pointer so IPA cannot clone
+ * or specialize the test body for these constants; the body is the same
+ * code that build-test_cases.sh compares.
+ */
+
+#include "../test_cases.cpp"
+
+#include "emu.h"
+
+#define EMU_REGION      0x800
+#define EMU_REGIONS     8
+
+extern "C" unsigned char emu_arena[EMU_REGION * EMU_REGIONS];
+
+/* Loop counts stay small so one call fits the 20M cycle budget */
+static constexpr long emu_ints[EMU_REGIONS] = { 24, 7, 3, 100, 5, 2, 9, 4 };
+
+/* --- Argument generation --- */
+
+template<class T> struct emu_arg {
+    static constexpr bool ok = __is_enum(T) || ((__is_class(T) || __is_union(T)) && __is_trivially_constructible(T));
+    static T make(int) { return T(); }
+};
+
+#define EMU_SCALAR_ARG(T) \
+    template<> struct emu_arg<T> { \
+        static constexpr bool ok = true; \
+        static T make(int pos) { return (T)emu_ints[pos]; } \
+    };
+EMU_SCALAR_ARG(bool)
+EMU_SCALAR_ARG(char)
+EMU_SCALAR_ARG(signed char)
+EMU_SCALAR_ARG(unsigned char)
+EMU_SCALAR_ARG(short)
+EMU_SCALAR_ARG(unsigned short)
+EMU_SCALAR_ARG(int)
+EMU_SCALAR_ARG(unsigned int)
+EMU_SCALAR_ARG(long)
+EMU_SCALAR_ARG(unsigned long)
+EMU_SCALAR_ARG(long long)
+EMU_SCALAR_ARG(unsigned long long)
+EMU_SCALAR_ARG(float)
+EMU_SCALAR_ARG(double)
+
+template<class T> struct emu_arg<T*> {
+    static constexpr bool ok = true;
+    static T* make(int pos) { return (T*)(emu_arena + pos * EMU_REGION); }
+};
+
+/* More specialized than T*, so callbacks never get an arena address */
+template<class R, class... A> struct emu_arg<R (*)(A...)> {
+    static constexpr bool ok = false;
+    static R (*make(int))(A...) { return nullptr; }
+};
+
+template<class T> struct emu_arg<T&> {
+    static constexpr bool ok = true;
+    static T& make(int pos) { return *(T*)(emu_arena + pos * EMU_REGION); }
+};
+
+/* --- Checksum (FNV-1a) --- */
+
+static unsigned long emu_hash(unsigned long h, const void *p, unsigned long n) {
+    const unsigned char *c = (const unsigned char *)p;
+    for (unsigned long i = 0; i < n; i++)
+        h = (h ^ c[i]) * 16777619UL;
+    return h;
+}
+
+/* Deterministic arena contents: bytes 1..63 with a NUL every 64 bytes,
+ * so string functions terminate and counts read from memory stay small. */
+static void emu_reset_arena() {
+    for (unsigned long i = 0; i < sizeof emu_arena; i++)
+        emu_arena[i] = (i & 63) == 63 ? 0 : (unsigned char)((i * 7 & 63) | 1);
+}
+
+/* --- Calling a test --- */
+
+template<int... I> struct emu_seq {};
+
+template<class R, class... A, int... I>
+static unsigned long emu_call(R (*f)(A...), emu_seq<I...>) {
+    if constexpr (!(true && ... && emu_arg<A>::ok)) {
+        EMU_SKIP = 1;
+        return 0;
+    } else {
+        R (*volatile fp)(A...) = f;
+        unsigned long h = 2166136261UL;
+        EMU_START = 1;
+        if constexpr (__is_same(R, void)) {
+            fp(emu_arg<A>::make(I)...);
+            EMU_STOP = 1;
+        } else {
+            R r = fp(emu_arg<A>::make(I)...);
+            EMU_STOP = 1;
+            h = emu_hash(h, &r, sizeof r);
+        }
+        return h;
+    }
+}
+
+template<class R, class... A>
+static unsigned long emu_run(R (*f)(A...)) {
+    static_assert(sizeof...(A) <= EMU_REGIONS, "too many parameters");
+    return emu_call(f, emu_seq<__integer_pack(sizeof...(A))...>());
+}
+
+/* The test list is generated by build-emu.sh: EMU_TEST(test_name) per line */
+typedef unsigned long (*emu_entry)();
+#define EMU_TEST(name) [] { return emu_run(name); },
+static const emu_entry emu_tests[] = {
+#include "test_list.h"
+};
+
+extern "C" int main() {
+    const unsigned long count = sizeof emu_tests / sizeof emu_tests[0];
+    for (unsigned long id = EMU_NEXT; id < count; id = EMU_NEXT) {
+        emu_reset_arena();
+        unsigned long h = emu_tests[id]();
+        EMU_RESULT = emu_hash(h, emu_arena, sizeof emu_arena);
+    }
+    return 0;
+}
@@ -0,0 +1,15 @@
+/* run68k marker registers (see emu/run68k.c).
+ * START/STOP bracket the measured region, RESULT takes the checksum,
+ * reading NEXT returns the next test index, SKIP marks a test not run.
+ */
+#ifndef EMU_H
+#define EMU_H
+
+#define EMU_REG(off)    (*(volatile unsigned long *)(0xfff000 + (off)))
+#define EMU_START       EMU_REG(0x00)
+#define EMU_STOP        EMU_REG(0x04)
+#define EMU_RESULT      EMU_REG(0x08)
+#define EMU_NEXT        EMU_REG(0x10)
+#define EMU_SKIP        EMU_REG(0x18)
+
+#endif
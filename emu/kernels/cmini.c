@@ -0,0 +1,177 @@
+/* libcmini kernels: the string functions programs linked against
+ * libcmini call most.  build-kernels.sh compiles each sources/<fn>.c that
+ * exists as cmini_<fn> and defines HAVE_CMINI_<FN>; missing ones skip.
+ */
+
+#include "kernel.h"
+
+void *cmini_memcpy(void *d, const void *s, size_t n);
+void *cmini_memset(void *d, int c, size_t n);
+int cmini_memcmp(const void *a, const void *b, size_t n);
+size_t cmini_strlen(const char *s);
+int cmini_strcmp(const char *a, const char *b);
+char *cmini_strcpy(char *d, const char *s);
+
+#define BUF     8192
+#define STRINGS 64
+
+static unsigned char buf_a[BUF], buf_b[BUF];
+
+/* STRINGS strings of 1..127 characters, NUL-terminated, in buf_a */
+static void make_strings(void)
+{
+    unsigned long i, pos = 0;
+    int s;
+    for (s = 0; s < STRINGS; s++) {
+        unsigned long len = 1 + kernel_rand() % 127;
+        for (i = 0; i < len; i++)
+            buf_a[pos++] = (unsigned char)('a' + kernel_rand() % 26);
+        buf_a[pos++] = 0;
+    }
+    while (pos < BUF)
+        buf_a[pos++] = 0;
+}
+
+static void fill_random(unsigned char *p)
+{
+    unsigned long i;
+    for (i = 0; i < BUF; i++)
+        p[i] = (unsigned char)kernel_rand();
+}
+
+static unsigned long run_memcpy(void)
+{
+#ifdef HAVE_CMINI_MEMCPY
+    int i;
+    fill_random(buf_a);
+    EMU_START = 1;
+    /* Aligned, odd source and odd destination */
+    cmini_memcpy(buf_b, buf_a, BUF);
+    cmini_memcpy(buf_b, buf_a + 1, BUF - 2);
+    for (i = 0; i < 64; i++)
+        cmini_memcpy(buf_b + 1 + i, buf_a + i * 2, 37);
+    EMU_STOP = 1;
+    return kernel_hash(KERNEL_HASH_INIT, buf_b, BUF);
+#else
+    EMU_SKIP = 1;
+    return 0;
+#endif
+}
+
+static unsigned long run_memset(void)
+{
+#ifdef HAVE_CMINI_MEMSET
+    int i;
+    EMU_START = 1;
+    cmini_memset(buf_b, 0x5a, BUF);
+    for (i = 0; i < 64; i++)
+        cmini_memset(buf_b + 1 + i * 3, i, 61);
+    EMU_STOP = 1;
+    return kernel_hash(KERNEL_HASH_INIT, buf_b, BUF);
+#else
+    EMU_SKIP = 1;
+    return 0;
+#endif
+}
+
+static unsigned long run_memcmp(void)
+{
+#ifdef HAVE_CMINI_MEMCMP
+    long r = 0;
+    int i;
+    fill_random(buf_a);
+    for (i = 0; i < BUF; i++)
+        buf_b[i] = buf_a[i];
+    buf_b[BUF - 3] ^= 1;
+    EMU_START = 1;
+    r += cmini_memcmp(buf_a, buf_b, BUF);
+    for (i = 0; i < 64; i++)
+        r += cmini_memcmp(buf_a + i, buf_b + i, 40);
+    EMU_STOP = 1;
+    return kernel_hash(KERNEL_HASH_INIT, &r, sizeof r);
+#else
+    EMU_SKIP = 1;
+    return 0;
+#endif
+}
+
+static unsigned long run_strlen(void)
+{
+#ifdef HAVE_CMINI_STRLEN
+    unsigned long total = 0, pos = 0;
+    int s;
+    make_strings();
+    EMU_START = 1;
+    for (s = 0; s < STRINGS; s++) {
+        size_t len = cmini_strlen((const char *)buf_a + pos);
+        total += len;
+        pos += len + 1;
+    }
+    EMU_STOP = 1;
+    return kernel_hash(KERNEL_HASH_INIT, &total, sizeof total);
+#else
+    EMU_SKIP = 1;
+    return 0;
+#endif
+}
+
+static unsigned long run_strcmp(void)
+{
+#if defined(HAVE_CMINI_STRCMP) && defined(HAVE_CMINI_STRLEN)
+    unsigned long pos = 0;
+    long r = 0;
+    int s;
+    make_strings();
+    for (s = 0; s < BUF; s++)
+        buf_b[s] = buf_a[s];
+    /* Every fourth string differs in its last character */
+    for (s = 0; s < STRINGS; s++) {
+        unsigned long end = pos + cmini_strlen((const char *)buf_a + pos);
+        if ((s & 3) == 0)
+            buf_b[end - 1] ^= 1;
+        pos = end + 1;
+    }
+    pos = 0;
+    EMU_START = 1;
+    for (s = 0; s < STRINGS; s++) {
+        r += cmini_strcmp((const char *)buf_a + pos, (const char *)buf_b + pos);
+        while (buf_a[pos++])
+            ;
+    }
+    EMU_STOP = 1;
+    return kernel_hash(KERNEL_HASH_INIT, &r, sizeof r);
+#else
+    EMU_SKIP = 1;
+    return 0;
+#endif
+}
+
+static unsigned long run_strcpy(void)
+{
+#ifdef HAVE_CMINI_STRCPY
+    unsigned long pos = 0;
+    int s;
+    make_strings();
+    EMU_START = 1;
+    for (s = 0; s < STRINGS; s++) {
+        cmini_strcpy((char *)buf_b + pos, (const char *)buf_a + pos);
+        while (buf_a[pos++])
+            ;
+    }
+    EMU_STOP = 1;
+    return kernel_hash(KERNEL_HASH_INIT, buf_b, BUF);
+#else
+    EMU_SKIP = 1;
+    return 0;
+#endif
+}
+
+const struct kernel_test kernel_tests[] = {
+    { "cmini_memcpy", run_memcpy },
+    { "cmini_memset", run_memset },
+    { "cmini_memcmp", run_memcmp },
+    { "cmini_strlen", run_strlen },
+    { "cmini_strcmp", run_strcmp },
+    { "cmini_strcpy", run_strcpy },
+};
+KERNEL_COUNT(kernel_tests);
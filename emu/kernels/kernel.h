@@ -0,0 +1,38 @@
+/* Shared declarations for the package kernel drivers (build-kernels.sh).
+ *
+ * Each driver defines kernel_tests[] with one { "name", run } entry per
+ * line; build-kernels.sh reads the names from those lines, so keep the
+ * entries in that form.  A run function does its setup, brackets only the
+ * package code with EMU_START/EMU_STOP and returns a checksum of the output.
+ */
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <stddef.h>
+#include "../emu.h"
+
+typedef unsigned long (*kernel_fn)(void);
+
+struct kernel_test {
+    const char *name;
+    kernel_fn run;
+};
+
+extern const struct kernel_test kernel_tests[];
+extern const unsigned long kernel_count;
+
+#define KERNEL_COUNT(tests) \
+    const unsigned long kernel_count = sizeof tests / sizeof tests[0]
+
+#define KERNEL_HASH_INIT 2166136261UL
+
+unsigned long kernel_hash(unsigned long h, const void *p, unsigned long n);
+unsigned long kernel_rand(void);
+void kernel_reset(void);
+
+void *malloc(size_t n);
+void *calloc(size_t n, size_t size);
+void *realloc(void *p, size_t n);
+void free(void *p);
+
+#endif
@@ -0,0 +1,36 @@
+/* mpg123 kernel: the 32-band DCT of the polyphase synthesis (dct64.c),
+ * the hot half of every decoded granule.  The package is configured with
+ * --with-cpu=generic_nofpu, so real is the fixed-point type on every CPU.
+ */
+
+#include "kernel.h"
+#include "mpg123lib_intern.h"
+
+#define GRANULES 36
+
+static real bands[GRANULES][32];
+static real out0[0x110], out1[0x110];
+
+static unsigned long run_dct64(void)
+{
+    unsigned long h = KERNEL_HASH_INIT;
+    int g, i;
+
+    prepare_decode_tables();
+    for (g = 0; g < GRANULES; g++)
+        for (i = 0; i < 32; i++)
+            bands[g][i] = (real)((long)(kernel_rand() & 0xfffff) - 0x80000);
+
+    EMU_START = 1;
+    for (g = 0; g < GRANULES; g++)
+        dct64(out0, out1, bands[g]);
+    EMU_STOP = 1;
+
+    h = kernel_hash(h, out0, sizeof out0);
+    return kernel_hash(h, out1, sizeof out1);
+}
+
+const struct kernel_test kernel_tests[] = {
+    { "mpg123_dct64", run_dct64 },
+};
+KERNEL_COUNT(kernel_tests);
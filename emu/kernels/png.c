@@ -0,0 +1,73 @@
+/* libpng kernels: the row unfilter functions from pngrutil.c, extracted
+ * into png_filters.c by "build-kernels.sh prepare" (they are static in
+ * libpng).  Each image cycles through Sub, Up, Average and Paeth rows.
+ */
+
+#include "kernel.h"
+#include "png.h"
+
+void png_read_filter_row_sub(png_row_infop row_info, png_bytep row, png_const_bytep prev_row);
+void png_read_filter_row_up(png_row_infop row_info, png_bytep row, png_const_bytep prev_row);
+void png_read_filter_row_avg(png_row_infop row_info, png_bytep row, png_const_bytep prev_row);
+void png_read_filter_row_paeth_1byte_pixel(png_row_infop row_info, png_bytep row, png_const_bytep prev_row);
+void png_read_filter_row_paeth_multibyte_pixel(png_row_infop row_info, png_bytep row, png_const_bytep prev_row);
+
+#define WIDTH   320
+#define ROWS    32
+
+static png_byte image[ROWS + 1][WIDTH * 4];
+
+static unsigned long unfilter(png_byte channels)
+{
+    png_row_info info;
+    unsigned long i;
+    int y;
+
+    info.width = WIDTH;
+    info.rowbytes = WIDTH * channels;
+    info.color_type = channels == 3 ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_GRAY;
+    info.bit_depth = 8;
+    info.channels = channels;
+    info.pixel_depth = (png_byte)(8 * channels);
+
+    /* Row 0 is the all-zero "previous row" of the first image row */
+    for (i = 0; i < sizeof image[0]; i++)
+        image[0][i] = 0;
+    for (y = 1; y <= ROWS; y++)
+        for (i = 0; i < info.rowbytes; i++)
+            image[y][i] = (png_byte)kernel_rand();
+
+    EMU_START = 1;
+    for (y = 1; y <= ROWS; y++) {
+        switch (y & 3) {
+        case 0: png_read_filter_row_sub(&info, image[y], image[y - 1]); break;
+        case 1: png_read_filter_row_up(&info, image[y], image[y - 1]); break;
+        case 2: png_read_filter_row_avg(&info, image[y], image[y - 1]); break;
+        case 3:
+            if (channels == 1)
+                png_read_filter_row_paeth_1byte_pixel(&info, image[y], image[y - 1]);
+            else
+                png_read_filter_row_paeth_multibyte_pixel(&info, image[y], image[y - 1]);
+            break;
+        }
+    }
+    EMU_STOP = 1;
+
+    return kernel_hash(KERNEL_HASH_INIT, image, sizeof image);
+}
+
+static unsigned long run_unfilter_gray(void)
+{
+    return unfilter(1);
+}
+
+static unsigned long run_unfilter_rgb(void)
+{
+    return unfilter(3);
+}
+
+const struct kernel_test kernel_tests[] = {
+    { "png_unfilter_gray", run_unfilter_gray },
+    { "png_unfilter_rgb", run_unfilter_rgb },
+};
+KERNEL_COUNT(kernel_tests);
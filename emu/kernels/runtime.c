@@ -0,0 +1,87 @@
+/* Runtime for the package kernel drivers: test loop, checksum,
+ * a deterministic random source and a bump allocator in the arena.
+ */
+
+#include "kernel.h"
+
+extern unsigned char emu_arena[];
+
+/* The arena starts at 0x80000 (emu/emu.ld checks the image ends below
+ * it); leave 64 KB below the stack at 0xf0000 */
+#define HEAP_SIZE   0x60000
+
+static size_t heap_used;
+static unsigned long rand_state;
+
+/* FNV-1a, as in emu/driver.cpp */
+unsigned long kernel_hash(unsigned long h, const void *p, unsigned long n)
+{
+    const unsigned char *c = p;
+    unsigned long i;
+    for (i = 0; i < n; i++)
+        h = (h ^ c[i]) * 16777619UL;
+    return h;
+}
+
+unsigned long kernel_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return rand_state >> 8;
+}
+
+/* Every test starts from an empty heap and the same random sequence */
+void kernel_reset(void)
+{
+    heap_used = 0;
+    rand_state = 1;
+}
+
+/* Blocks carry their size in front so realloc can copy */
+void *malloc(size_t n)
+{
+    size_t *p;
+    n = (n + 7) & ~(size_t)7;
+    if (n + 8 > HEAP_SIZE - heap_used)
+        return 0;
+    p = (size_t *)(emu_arena + heap_used);
+    heap_used += n + 8;
+    p[0] = n;
+    return (unsigned char *)p + 8;
+}
+
+void *calloc(size_t n, size_t size)
+{
+    unsigned char *p = malloc(n * size);
+    size_t i;
+    if (p)
+        for (i = 0; i < n * size; i++)
+            p[i] = 0;
+    return p;
+}
+
+void *realloc(void *old, size_t n)
+{
+    unsigned char *p = malloc(n);
+    size_t i, len;
+    if (p && old) {
+        len = ((size_t *)((unsigned char *)old - 8))[0];
+        for (i = 0; i < len && i < n; i++)
+            p[i] = ((unsigned char *)old)[i];
+    }
+    return p;
+}
+
+void free(void *p)
+{
+    (void)p;
+}
+
+int main(void)
+{
+    unsigned long id;
+    for (id = EMU_NEXT; id < kernel_count; id = EMU_NEXT) {
+        kernel_reset();
+        EMU_RESULT = kernel_tests[id].run();
+    }
+    return 0;
+}
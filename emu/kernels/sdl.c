@@ -0,0 +1,120 @@
+/* SDL 1.2 kernels: software fill and blits between 320x200 surfaces.
+ * Only the src/video surface/blit code is linked; there is no video
+ * device, so current_video is NULL and error reporting is stubbed.
+ */
+
+#include "kernel.h"
+#include "SDL_video.h"
+#include "SDL_error.h"
+
+#define W 320
+#define H 200
+
+struct SDL_VideoDevice *current_video;
+
+void SDL_SetError(const char *fmt, ...)
+{
+    (void)fmt;
+}
+
+void SDL_Error(SDL_errorcode code)
+{
+    (void)code;
+}
+
+void SDL_ClearError(void)
+{
+}
+
+static SDL_Surface *surface16(void)
+{
+    return SDL_CreateRGBSurface(SDL_SWSURFACE, W, H, 16, 0xf800, 0x07e0, 0x001f, 0);
+}
+
+static SDL_Surface *surface32(void)
+{
+    return SDL_CreateRGBSurface(SDL_SWSURFACE, W, H, 32, 0xff0000, 0x00ff00, 0x0000ff, 0);
+}
+
+static void randomize(SDL_Surface *s)
+{
+    unsigned char *p = s->pixels;
+    unsigned long i;
+    for (i = 0; i < (unsigned long)s->pitch * s->h; i++)
+        p[i] = (unsigned char)kernel_rand();
+}
+
+static unsigned long checksum(SDL_Surface *s)
+{
+    return kernel_hash(KERNEL_HASH_INIT, s->pixels, (unsigned long)s->pitch * s->h);
+}
+
+static unsigned long run_fill16(void)
+{
+    SDL_Surface *dst = surface16();
+    SDL_Rect r;
+    int i;
+
+    if (!dst)
+        return 0;
+    EMU_START = 1;
+    for (i = 0; i < 8; i++) {
+        r.x = (Sint16)(i * 7);
+        r.y = (Sint16)(i * 5);
+        r.w = (Uint16)(W - i * 14);
+        r.h = (Uint16)(H - i * 10);
+        SDL_FillRect(dst, &r, SDL_MapRGB(dst->format, (Uint8)(i * 30), 0x80, (Uint8)(255 - i * 30)));
+    }
+    EMU_STOP = 1;
+    return checksum(dst);
+}
+
+static unsigned long blit(SDL_Surface *src, SDL_Surface *dst)
+{
+    if (!src || !dst)
+        return 0;
+    randomize(src);
+    randomize(dst);
+    /* Builds the blit map outside the measured region */
+    SDL_BlitSurface(src, NULL, dst, NULL);
+
+    EMU_START = 1;
+    SDL_BlitSurface(src, NULL, dst, NULL);
+    EMU_STOP = 1;
+    return checksum(dst);
+}
+
+static unsigned long run_blit_copy16(void)
+{
+    return blit(surface16(), surface16());
+}
+
+static unsigned long run_blit_888_to_565(void)
+{
+    return blit(surface32(), surface16());
+}
+
+static unsigned long run_blit_colorkey16(void)
+{
+    SDL_Surface *src = surface16();
+    if (src)
+        SDL_SetColorKey(src, SDL_SRCCOLORKEY, 0);
+    return blit(src, surface16());
+}
+
+static unsigned long run_blit_alpha16(void)
+{
+    SDL_Surface *src = surface16();
+    if (src)
+        SDL_SetAlpha(src, SDL_SRCALPHA, 128);
+    return blit(src, surface16());
+}
+
+const struct kernel_test kernel_tests[] = {
+    { "sdl_fill16", run_fill16 },
+    { "sdl_blit_copy16", run_blit_copy16 },
+    { "sdl_blit_888_to_565", run_blit_888_to_565 },
+    { "sdl_blit_colorkey16", run_blit_colorkey16 },
+    { "sdl_blit_alpha16", run_blit_alpha16 },
+};
+KERNEL_COUNT(kernel_tests);
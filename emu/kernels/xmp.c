@@ -0,0 +1,63 @@
+/* libxmp-lite kernels: the software mixer loops from mix_all.c, mixing
+ * one mono sample into the stereo output buffer with linear
+ * interpolation, as the player does for every voice.
+ */
+
+#include "kernel.h"
+#include "common.h"
+#include "mixer.h"
+
+void libxmp_mix_stereo_8bit_linear(struct mixer_voice *vi, int32 *buffer,
+    int count, int vl, int vr, int step, int ramp, int delta_l, int delta_r);
+void libxmp_mix_stereo_16bit_linear(struct mixer_voice *vi, int32 *buffer,
+    int count, int vl, int vr, int step, int ramp, int delta_l, int delta_r);
+
+#define FRAMES  1024
+#define SAMPLES 4096
+
+static int32 buffer[FRAMES * 2];
+static int16 sample16[SAMPLES];
+static int8 sample8[SAMPLES];
+
+typedef void (*mix_fn)(struct mixer_voice *, int32 *, int, int, int, int, int, int, int);
+
+static unsigned long mix(mix_fn fn, void *sample)
+{
+    struct mixer_voice vi;
+    unsigned long i;
+
+    for (i = 0; i < sizeof vi; i++)
+        ((unsigned char *)&vi)[i] = 0;
+    vi.sptr = sample;
+    for (i = 0; i < FRAMES * 2; i++)
+        buffer[i] = 0;
+
+    /* Resampling ratio 1.4, volumes as the player passes them */
+    EMU_START = 1;
+    fn(&vi, buffer, FRAMES, 0x30, 0x20, (7 << SMIX_SHIFT) / 5, 0, 0, 0);
+    EMU_STOP = 1;
+
+    return kernel_hash(KERNEL_HASH_INIT, buffer, sizeof buffer);
+}
+
+static unsigned long run_mix_8bit(void)
+{
+    unsigned long i;
+    for (i = 0; i < SAMPLES; i++)
+        sample8[i] = (int8)kernel_rand();
+    return mix(libxmp_mix_stereo_8bit_linear, sample8);
+}
+
+static unsigned long run_mix_16bit(void)
+{
+    unsigned long i;
+    for (i = 0; i < SAMPLES; i++)
+        sample16[i] = (int16)kernel_rand();
+    return mix(libxmp_mix_stereo_16bit_linear, sample16);
+}
+
+const struct kernel_test kernel_tests[] = {
+    { "xmp_mix_8bit", run_mix_8bit },
+    { "xmp_mix_16bit", run_mix_16bit },
+};
+KERNEL_COUNT(kernel_tests);
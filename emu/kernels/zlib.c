@@ -0,0 +1,71 @@
+/* zlib kernels: inflate of a fixed deflate stream, crc32 over 32 KB.
+ * Built with -DZ_SOLO; allocation goes through the runtime heap.
+ * zlib_input.h is generated by "build-kernels.sh prepare".
+ */
+
+#include "kernel.h"
+#include "zlib.h"
+#include "zlib_input.h"
+
+static unsigned char plain[ZLIB_PLAIN_SIZE];
+
+static voidpf kernel_zalloc(voidpf opaque, uInt items, uInt size)
+{
+    (void)opaque;
+    return calloc(items, size);
+}
+
+static void kernel_zfree(voidpf opaque, voidpf p)
+{
+    (void)opaque;
+    free(p);
+}
+
+static unsigned long run_inflate(void)
+{
+    z_stream zs;
+    unsigned long h;
+    int ret;
+
+    zs.zalloc = kernel_zalloc;
+    zs.zfree = kernel_zfree;
+    zs.opaque = Z_NULL;
+    zs.next_in = Z_NULL;
+    zs.avail_in = 0;
+    if (inflateInit(&zs) != Z_OK)
+        return 0;
+    zs.next_in = (Bytef *)zlib_input;
+    zs.avail_in = sizeof zlib_input;
+    zs.next_out = plain;
+    zs.avail_out = sizeof plain;
+
+    EMU_START = 1;
+    ret = inflate(&zs, Z_FINISH);
+    EMU_STOP = 1;
+
+    h = kernel_hash(KERNEL_HASH_INIT, plain, zs.total_out);
+    h = kernel_hash(h, &ret, sizeof ret);
+    inflateEnd(&zs);
+    return h;
+}
+
+static unsigned long run_crc32(void)
+{
+    unsigned long i, crc;
+
+    for (i = 0; i < sizeof plain; i++)
+        plain[i] = (unsigned char)kernel_rand();
+
+    EMU_START = 1;
+    crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, plain, sizeof plain);
+    EMU_STOP = 1;
+
+    return kernel_hash(KERNEL_HASH_INIT, &crc, sizeof crc);
+}
+
+const struct kernel_test kernel_tests[] = {
+    { "zlib_inflate", run_inflate },
+    { "zlib_crc32", run_crc32 },
+};
+KERNEL_COUNT(kernel_tests);
@@ -0,0 +1,78 @@
+/* Minimal string functions for the emulator driver (linked with -nostdlib).
+ * Compiled with -fno-builtin -fno-tree-loop-distribute-patterns so that
+ * the loops are not turned back into calls to themselves.
+ */
+
+typedef __SIZE_TYPE__ size_t;
+
+void *memcpy(void *d, const void *s, size_t n)
+{
+    unsigned char *dp = d;
+    const unsigned char *sp = s;
+    while (n--)
+        *dp++ = *sp++;
+    return d;
+}
+
+void *memmove(void *d, const void *s, size_t n)
+{
+    unsigned char *dp = d;
+    const unsigned char *sp = s;
+    if (dp < sp) {
+        while (n--)
+            *dp++ = *sp++;
+    } else {
+        while (n--)
+            dp[n] = sp[n];
+    }
+    return d;
+}
+
+void *memset(void *d, int c, size_t n)
+{
+    unsigned char *dp = d;
+    while (n--)
+        *dp++ = (unsigned char)c;
+    return d;
+}
+
+int memcmp(const void *a, const void *b, size_t n)
+{
+    const unsigned char *ap = a, *bp = b;
+    for (; n; n--, ap++, bp++)
+        if (*ap != *bp)
+            return *ap - *bp;
+    return 0;
+}
+
+void *memchr(const void *p, int c, size_t n)
+{
+    const unsigned char *cp = p;
+    for (; n; n--, cp++)
+        if (*cp == (unsigned char)c)
+            return (void *)cp;
+    return 0;
+}
+
+size_t strlen(const char *s)
+{
+    const char *p = s;
+    while (*p)
+        p++;
+    return p - s;
+}
+
+int strcmp(const char *a, const char *b)
+{
+    while (*a && *a == *b)
+        a++, b++;
+    return (unsigned char)*a - (unsigned char)*b;
+}
+
+char *strcpy(char *d, const char *s)
+{
+    char *r = d;
+    while ((*d++ = *s++))
+        ;
+    return r;
+}
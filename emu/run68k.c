@@ -0,0 +1,294 @@
+/* run68k - headless runner for the test_cases emulator driver.
+ *
+ * Loads a flat binary image (emu/emu.ld) at address 0 into 1 MB of RAM,
+ * resets a Musashi 68000/020/030/040 core and services the driver's
+ * memory-mapped registers at 0xfff000.  For every test function the
+ * driver reports, one line is printed:
+ *
+ *   name <TAB> cycles <TAB> checksum <TAB> status
+ *
+ * status is "ok", "stray" (read or wrote outside RAM; reads return 0),
+ * "skip" (the driver could not build arguments), "fault" (exception) or
+ * "timeout".  After a fault or timeout the image is reloaded (so .data
+ * is clean again), the CPU is reset and the driver resumes with the next
+ * test.  Musashi must be built with M68K_EMULATE_ADDRESS_ERROR (see
+ * build-emu.sh prepare) so odd word/long accesses fault on the 68000.
+ *
+ * Cycles are Musashi's instruction timings with no wait states; they
+ * include argument setup, jsr/rts and one marker store.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "m68k.h"
+
+#define RAM_SIZE    0x100000
+#define MMIO_BASE   0xfff000
+#define MMIO_START  0x00    /* write: test begins */
+#define MMIO_STOP   0x04    /* write: test returned */
+#define MMIO_RESULT 0x08    /* write: checksum of return value + arena */
+#define MMIO_EXIT   0x0c    /* write: driver finished */
+#define MMIO_NEXT   0x10    /* read: index of the next test to run */
+#define MMIO_FAULT  0x14    /* write: unexpected exception */
+#define MMIO_SKIP   0x18    /* write: test not drivable */
+
+#define SLICE       100000
+
+static unsigned char ram[RAM_SIZE];
+static unsigned char *image;
+static size_t image_size;
+static char **names;
+static unsigned int name_count;
+
+static unsigned long long total_cycles;   /* cycles before the current slice */
+static unsigned long long t_start, t_stop;
+static unsigned long long limit = 20000000ULL;
+static unsigned int next_test, cur_test;
+static int in_test, stray, skipped, fault, done;
+
+static unsigned long long now(void)
+{
+    return total_cycles + (unsigned long long)m68k_cycles_run();
+}
+
+static const char *test_name(unsigned int id)
+{
+    return id < name_count ? names[id] : "?";
+}
+
+static void report(const char *cycles, unsigned int checksum, const char *status)
+{
+    printf("%s\t%s\t%08x\t%s\n", test_name(cur_test), cycles, checksum, status);
+}
+
+static void mmio_write(unsigned int reg, unsigned int value)
+{
+    char buf[32];
+
+    switch (reg) {
+    case MMIO_START:
+        in_test = 1;
+        stray = 0;
+        skipped = 0;
+        t_start = now();
+        break;
+    case MMIO_STOP:
+        in_test = 0;
+        t_stop = now();
+        break;
+    case MMIO_RESULT:
+        if (skipped) {
+            report("-", value, "skip");
+        } else {
+            snprintf(buf, sizeof buf, "%llu", t_stop - t_start);
+            report(buf, value, stray ? "stray" : "ok");
+        }
+        break;
+    case MMIO_SKIP:
+        skipped = 1;
+        break;
+    case MMIO_FAULT:
+        fault = 1;
+        m68k_end_timeslice();
+        break;
+    case MMIO_EXIT:
+        done = 1;
+        m68k_end_timeslice();
+        break;
+    }
+}
+
+static unsigned int mmio_read(unsigned int reg)
+{
+    if (reg == MMIO_NEXT) {
+        cur_test = next_test++;
+        return cur_test;
+    }
+    return 0;
+}
+
+/* --- Musashi memory callbacks (big-endian) --- */
+
+unsigned int m68k_read_memory_8(unsigned int a)
+{
+    if (a < RAM_SIZE)
+        return ram[a];
+    stray = 1;
+    return 0;
+}
+
+unsigned int m68k_read_memory_16(unsigned int a)
+{
+    if (a + 1 < RAM_SIZE)
+        return (ram[a] << 8) | ram[a + 1];
+    stray = 1;
+    return 0;
+}
+
+unsigned int m68k_read_memory_32(unsigned int a)
+{
+    if (a >= MMIO_BASE && a < MMIO_BASE + 0x100)
+        return mmio_read(a - MMIO_BASE);
+    if (a + 3 < RAM_SIZE)
+        return ((unsigned int)ram[a] << 24) | (ram[a + 1] << 16) | (ram[a + 2] << 8) | ram[a + 3];
+    stray = 1;
+    return 0;
+}
+
+void m68k_write_memory_8(unsigned int a, unsigned int v)
+{
+    if (a < RAM_SIZE)
+        ram[a] = v;
+    else
+        stray = 1;
+}
+
+void m68k_write_memory_16(unsigned int a, unsigned int v)
+{
+    if (a + 1 < RAM_SIZE) {
+        ram[a] = v >> 8;
+        ram[a + 1] = v;
+    } else {
+        stray = 1;
+    }
+}
+
+void m68k_write_memory_32(unsigned int a, unsigned int v)
+{
+    if (a >= MMIO_BASE && a < MMIO_BASE + 0x100) {
+        mmio_write(a - MMIO_BASE, v);
+    } else if (a + 3 < RAM_SIZE) {
+        ram[a] = v >> 24;
+        ram[a + 1] = v >> 16;
+        ram[a + 2] = v >> 8;
+        ram[a + 3] = v;
+    } else {
+        stray = 1;
+    }
+}
+
+unsigned int m68k_read_disassembler_8(unsigned int a)  { return a < RAM_SIZE ? ram[a] : 0; }
+unsigned int m68k_read_disassembler_16(unsigned int a) { return m68k_read_memory_16(a); }
+unsigned int m68k_read_disassembler_32(unsigned int a) { return m68k_read_memory_32(a); }
+
+/* --- Setup --- */
+
+static void load_names(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[256];
+    unsigned int cap = 0;
+
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    while (fgets(line, sizeof line, f)) {
+        line[strcspn(line, "\r\n")] = 0;
+        if (!line[0])
+            continue;
+        if (name_count == cap) {
+            cap = cap ? cap * 2 : 256;
+            names = realloc(names, cap * sizeof *names);
+        }
+        names[name_count++] = strdup(line);
+    }
+    fclose(f);
+}
+
+static void load_image(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    image = malloc(RAM_SIZE);
+    image_size = fread(image, 1, RAM_SIZE, f);
+    fclose(f);
+    if (image_size < 8) {
+        fprintf(stderr, "%s: image too small\n", path);
+        exit(1);
+    }
+}
+
+/* Fresh RAM: the image at 0, zeros above (crt0 clears .bss itself) */
+static void restore_image(void)
+{
+    memcpy(ram, image, image_size);
+    memset(ram + image_size, 0, RAM_SIZE - image_size);
+}
+
+static int cpu_type(const char *cpu)
+{
+    if (!strcmp(cpu, "000")) return M68K_CPU_TYPE_68000;
+    if (!strcmp(cpu, "010")) return M68K_CPU_TYPE_68010;
+    if (!strcmp(cpu, "020")) return M68K_CPU_TYPE_68020;
+    if (!strcmp(cpu, "030")) return M68K_CPU_TYPE_68030;
+    if (!strcmp(cpu, "040")) return M68K_CPU_TYPE_68040;
+    fprintf(stderr, "Error: no Musashi core for CPU '%s' (000/010/020/030/040)\n", cpu);
+    exit(1);
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "Usage: %s [-c CPU] [-l CYCLES] <image.bin> <names.txt>\n", argv0);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    const char *cpu = "000";
+    int i;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (!strcmp(argv[i], "-c") && i + 1 < argc)
+            cpu = argv[++i];
+        else if (!strcmp(argv[i], "-l") && i + 1 < argc)
+            limit = strtoull(argv[++i], NULL, 0);
+        else
+            usage(argv[0]);
+    }
+    if (argc - i != 2)
+        usage(argv[0]);
+
+    load_image(argv[i]);
+    load_names(argv[i + 1]);
+    restore_image();
+
+    m68k_init();
+    m68k_set_cpu_type(cpu_type(cpu));
+    m68k_pulse_reset();
+
+    while (!done) {
+        total_cycles += (unsigned long long)m68k_execute(SLICE);
+
+        if (fault && !in_test) {
+            fprintf(stderr, "Error: exception outside a test (driver startup?)\n");
+            return 1;
+        }
+        if (in_test && !fault && total_cycles - t_start > limit) {
+            report("-", 0, "timeout");
+            fault = 2;
+        } else if (fault == 1) {
+            report("-", 0, "fault");
+        }
+        if (fault) {
+            /* Restart the driver on a clean image (the faulting test may
+             * have scribbled over globals); it asks for the next test
+             * index, which lives here in run68k */
+            fault = 0;
+            in_test = 0;
+            restore_image();
+            m68k_pulse_reset();
+        }
+        if (next_test > name_count + 1) {
+            fprintf(stderr, "Error: driver ran past the test list\n");
+            return 1;
+        }
+    }
+    return 0;
+}
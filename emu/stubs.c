@@ -0,0 +1,49 @@
+/* Definitions for the externals that test_cases.cpp only declares.
+ * Kept in their own translation unit so the test bodies are compiled
+ * against opaque externals, exactly as in build-test_cases.sh.
+ */
+
+struct point_s { short x, y; };
+struct mixed_fields_s { long a; short b, c; long d; short e, f; };
+
+unsigned short ext_table[256];
+struct mixed_fields_s g_mixed;
+unsigned char g_tile_map[64 * 64];
+
+void use_point(void *canvas, void *image, void *rect, struct point_s p)
+{
+    (void)canvas; (void)image; (void)rect; (void)p;
+}
+
+void *alloc_obj(void)
+{
+    static long obj[16];
+    return obj;
+}
+
+short get_count(void *obj)
+{
+    (void)obj;
+    return 3;
+}
+
+void draw_tile(void *canvas, void *tile, short idx, struct point_s at, int color)
+{
+    (void)canvas; (void)tile; (void)idx; (void)at; (void)color;
+}
+
+void use_mixed(struct mixed_fields_s *m)
+{
+    (void)m;
+}
+
+short appl_find_stub(const char *name)
+{
+    (void)name;
+    return -1;
+}
+
+void consume4(long a, long b, long c, long d)
+{
+    (void)a; (void)b; (void)c; (void)d;
+}
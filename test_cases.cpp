@@ -551,6 +551,49 @@ extern "C" {
         return vec.emplace_back(a);
     }
     
+    /* ==========================================================================
+     * WORD-INDEX ADDRESSING TEST CASES
+     *
+     * (a0,d0.w) indexes with a sign-extended 16-bit index, and movea.w /
+     * adda.w sign-extend their source for free.  When an index is a short,
+     * or an int whose range fits in 16 bits, the ext.l before (a0,d0.l) or
+     * adda.l is redundant.  See M68K_OPTIMIZATIONS.md Appendix B.9.
+     * ========================================================================== */
+    
+    /* test_word_index_short - short index into a short array
+     * Expected for 68020+: move.w (a0,d0.w*2),d0, no ext.l
+     * Expected for 68000: unchanged; i * 2 may overflow 16 bits, so the
+     *   scaled index must stay 32-bit without a range guarantee
+     */
+    short __attribute__((noinline))
+    test_word_index_short(short *arr, short i) {
+        return arr[i];
+    }
+    
+    /* test_word_index_loop - range-limited short index reused for two arrays
+     * The mask bounds i to 0..0x3fff, so i * 2 fits in a signed word.
+     * Expected for 68000: add.w dN,dN + (aN,dN.w) for both loads, index
+     *   kept in a data register, no ext.l per iteration
+     * Savings: 4 cycles, 2 bytes per iteration
+     */
+    int __attribute__((noinline))
+    test_word_index_loop(const short *a, const short *b, const short *idx, short n) {
+        int sum = 0;
+        for (short k = 0; k < n; k++) {
+            short i = idx[k] & 0x3fff;
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+    
+    /* test_adda_word - pointer plus short offset
+     * Expected: adda.w d0,a0 instead of ext.l d0 + adda.l d0,a0
+     */
+    char * __attribute__((noinline))
+    test_adda_word(char *p, short off) {
+        return p + off;
+    }
+    
     /* ==========================================================================
      * ANDI.L #65535 ELIMINATION TEST CASES
      *
@@ -844,6 +887,55 @@ extern "C" {
         return s;
     }
     
+    /* ==========================================================================
+     * SWAR (SIMD WITHIN A REGISTER) TEST CASES
+     *
+     * Paired short and quad byte operations that could be processed as one
+     * 32-bit data-register operation per pair/quad: move.l loads/stores,
+     * and/or/eor directly, add/sub with lane masks where carries could cross.
+     * See M68K_OPTIMIZATIONS.md Appendix B.10.
+     * ========================================================================== */
+    
+    /* test_swar_mask_bytes - byte-wise masking blit
+     * Expected: move.l (a0)+,d0 + and.l (a1)+,d0 + move.l d0,(a2)+ per
+     *   4 bytes instead of 4x move.b/and.b/move.b.  On 68000 this needs
+     *   word-aligned pointers (see Appendix B.11 for alignment versioning).
+     */
+    void __attribute__((noinline))
+    test_swar_mask_bytes(unsigned char *__restrict dst, const unsigned char *__restrict src,
+                         const unsigned char *__restrict mask, unsigned short n) {
+        for (unsigned int i = 0; i < n * 4u; i++)
+            dst[i] = src[i] & mask[i];
+    }
+    
+    /* test_swar_point_add - coordinate pair addition
+     * Lanes are independent 16-bit adds; carry out of the low lane must not
+     *   reach the high lane.
+     * Expected: add.w for the low lane, swap + add.w + swap for the high
+     *   lane, one move.l store (no carry masking needed on two lanes)
+     */
+    struct s4 test_swar_point_add(struct s4 a, struct s4 b) {
+        return { (short)(a.a + b.a), (short)(a.b + b.b) };
+    }
+    
+    /* test_swar_palette_fade - fade 16 ST palette entries towards black
+     * Each entry is 0x0RGB with 3-bit channels; subtracting 0x111 per step
+     *   must saturate per channel, so borrow is prevented with a lane mask.
+     * Expected: two palette entries per move.l, with and.l #$07770777 lane
+     *   masks around the subtract
+     */
+    void __attribute__((noinline))
+    test_swar_palette_fade(unsigned short *pal) {
+        for (short i = 0; i < 16; i++) {
+            unsigned short c = pal[i];
+            unsigned short r = c & 0x700, g = c & 0x070, b = c & 0x007;
+            if (r) r -= 0x100;
+            if (g) g -= 0x010;
+            if (b) b -= 0x001;
+            pal[i] = r | g | b;
+        }
+    }
+    
     struct bit_struct_s {
         unsigned char id;
         unsigned char active: 1;
@@ -1446,5 +1538,444 @@ extern "C" {
         return m.a;
     }
     
+    /* ==========================================================================
+     * 32-BIT MULTIPLY/DIVIDE LIBCALL TEST CASES
+     *
+     * On 68000/68010 there is no 32x32 multiply or 32/32 divide, so any
+     * operation that m68k_pass_narrow_index_mult cannot prove narrow becomes
+     * jsr __mulsi3 / __divsi3 / __udivsi3 / __modsi3 / __umodsi3.  These are
+     * the call sites a register-argument libgcc variant would speed up; see
+     * M68K_OPTIMIZATIONS.md Appendix B.7.
+     * ========================================================================== */
+    
+    /* test_mulsi3_libcall - operands not provably narrow
+     * Expected for 68000: jsr __mulsi3 (68020+: muls.l)
+     */
+    long __attribute__((noinline))
+    test_mulsi3_libcall(long a, long b) {
+        return a * b;
+    }
+    
+    /* test_udivsi3_libcall - unsigned division with runtime-narrow operands
+     * Typical UI layout use: both operands fit in 16 bits at runtime, but
+     * VRP cannot prove it, so the full 32/32 libcall is used.
+     * Expected for 68000: jsr __udivsi3 (68020+: divul.l)
+     */
+    unsigned long __attribute__((noinline))
+    test_udivsi3_libcall(unsigned long width, unsigned long cols) {
+        return width / cols;
+    }
+    
+    /* test_divmod_libcall - quotient and remainder of the same operands
+     * Expected for 68000: jsr __divsi3 + jsr __modsi3, with live values
+     *   (p) kept in call-saved registers across both calls.
+     */
+    void __attribute__((noinline))
+    test_divmod_libcall(long pos, long step, long *p) {
+        p[0] = pos / step;
+        p[1] = pos % step;
+    }
+    
+    /* ==========================================================================
+     * DIVISION BY CONSTANT TEST CASES (16-bit dividends)
+     *
+     * On 68000 there is no 32x32->64 high multiply, so GCC's generic magic-
+     * number division is not available for SImode and it falls back to
+     * divu.w (up to ~140 cycles) or a libcall.  When the dividend is known to
+     * fit in 16 bits, x / C can instead be computed as mulu.w #M + swap +
+     * lsr.w, e.g. x / 20 == ((x >> 2) * 0xCCCD) >> 18 (~70 cycles).
+     * See M68K_OPTIMIZATIONS.md Appendix B.8.
+     * ========================================================================== */
+    
+    /* test_div20_word - tile coordinate division
+     * Expected for 68000: lsr.w #2 + mulu.w #0xCCCD + swap + lsr.w #2
+     *   instead of divu.w #20
+     */
+    unsigned short __attribute__((noinline))
+    test_div20_word(unsigned short x) {
+        return x / 20;
+    }
+    
+    /* test_mod20_word - remainder from the same reciprocal
+     * Expected for 68000: quotient via mulu.w, then x - q * 20 with
+     *   shift/add (q * 20 = (q << 4) + (q << 2)) instead of divu.w + swap
+     */
+    unsigned short __attribute__((noinline))
+    test_mod20_word(unsigned short x) {
+        return x % 20;
+    }
+    
+    /* test_div10_bounded - 32-bit int dividend bounded by VRP
+     * The range hint limits x to 16 bits, so the same mulu.w sequence
+     * applies even without -mshort.
+     * Expected for 68000: mulu.w #0xCCCD + swap + lsr.w #3 (no libcall)
+     */
+    unsigned int __attribute__((noinline))
+    test_div10_bounded(unsigned int x) {
+        if (x > 0xffff) __builtin_unreachable();
+        return x / 10;
+    }
+    
+    /* test_div_mod16_signed - signed power-of-two division and remainder
+     * Already open-coded by GCC; included so cost-model changes to the
+     * division expansion do not regress the power-of-two case.
+     */
+    void __attribute__((noinline))
+    test_div_mod16_signed(short x, short *q, short *r) {
+        *q = x / 16;
+        *r = x % 16;
+    }
+    
+    /* ==========================================================================
+     * ALIGNMENT-VERSIONED BYTE LOOP TEST CASES
+     *
+     * The 68000 raises an address error on odd word/long accesses, so byte
+     * loops run one byte per iteration.  When (src ^ dst) & 1 == 0 at run
+     * time, a one-byte prologue aligns both pointers and the body can use
+     * move.l (a0)+,(a1)+.  See M68K_OPTIMIZATIONS.md Appendix B.11.
+     * ========================================================================== */
+    
+    /* test_memcpy_bytes - plain byte copy
+     * Expected for 68000: runtime (src ^ dst) & 1 check, byte prologue,
+     *   move.l (a0)+,(a1)+ main loop, tablejump byte epilogue; byte loop
+     *   kept as the fallback path
+     * Savings: ~4x per byte on the aligned path (20 cycles/long vs
+     *   4x 12 cycles/byte + loop control)
+     */
+    void __attribute__((noinline))
+    test_memcpy_bytes(char *__restrict dst, const char *__restrict src, unsigned short n) {
+        while (n--)
+            *dst++ = *src++;
+    }
+    
+    /* test_libcmini_memcmp - libcmini memcmp (M68K_OPTIMIZATIONS.md Appendix A)
+     * Expected for 68000: aligned path compares cmp.l (a0)+,(a1)+ (cmpm.l)
+     *   and falls back to bytes to locate the first difference
+     */
+    int __attribute__((noinline))
+    test_libcmini_memcmp(const void *s1, const void *s2, unsigned long n) {
+        const unsigned char *p1 = (const unsigned char *)s1;
+        const unsigned char *p2 = (const unsigned char *)s2;
+        while (n--) {
+            if (*p1 != *p2) return *p1 - *p2;
+            p1++; p2++;
+        }
+        return 0;
+    }
+    
+    /* ==========================================================================
+     * CONDITION-CODE RETURN TEST CASES
+     *
+     * A function ending in moveq/move into d0 returns with CC already set
+     * from the return value, but callers always emit tst before branching on
+     * it.  For local and fastcall functions the caller could trust CC after
+     * the jsr.  See M68K_OPTIMIZATIONS.md Appendix B.12.
+     * ========================================================================== */
+    
+    extern unsigned char g_tile_map[64 * 64];
+    
+    /* is_solid - local predicate; every return path ends in a move into d0
+     * Expected: callee unchanged (sne/neg.b or moveq sets CC last)
+     */
+    static bool __attribute__((noinline))
+    is_solid(short x, short y) {
+        return g_tile_map[(y << 6) + x] >= 0x80;
+    }
+    
+    /* test_cc_return_bool - branch on a local bool predicate
+     * Expected: jsr is_solid + jne, no tst.b d0 between them
+     * Savings: 4 cycles, 2 bytes per call site
+     */
+    short __attribute__((noinline))
+    test_cc_return_bool(short x, short y) {
+        short steps = 0;
+        while (!is_solid(x, y + steps) && steps < 64)
+            steps++;
+        return steps;
+    }
+    
+    /* test_cc_return_extern - same pattern against an unknown callee
+     * Expected: tst.w d0 kept, the callee's CC state is not known
+     */
+    extern short appl_find_stub(const char *name);
+    short __attribute__((noinline))
+    test_cc_return_extern(const char *name) {
+        if (appl_find_stub(name) < 0)
+            return -1;
+        return 0;
+    }
+    
+    /* ==========================================================================
+     * OS TRAP CALL TEST CASES
+     *
+     * mintlib/gemlib bindings wrap trap #1/#13/#14 in inline asm that
+     * clobbers d0-d2/a0-a2 and memory, so every live value is spilled or
+     * moved to a callee-saved register around each call, and the stack
+     * cleanup of consecutive traps cannot be merged.  The helpers below use
+     * the same asm shape as mintlib's osbind.h.  See M68K_OPTIMIZATIONS.md
+     * Appendix B.13.
+     * ========================================================================== */
+    
+    static __forceinline long
+    trap_14_www(short n, short a, short b) {
+        register long retvalue __asm__("d0");
+        __asm__ volatile (
+            "movw %3,%%sp@-\n\t"
+            "movw %2,%%sp@-\n\t"
+            "movw %1,%%sp@-\n\t"
+            "trap #14\n\t"
+            "addql #6,%%sp"
+            : "=r"(retvalue)
+            : "g"(n), "r"(a), "r"(b)
+            : "d1", "d2", "a0", "a1", "a2", "cc", "memory");
+        return retvalue;
+    }
+    
+    static __forceinline long
+    trap_14_w(short n) {
+        register long retvalue __asm__("d0");
+        __asm__ volatile (
+            "movw %1,%%sp@-\n\t"
+            "trap #14\n\t"
+            "addql #2,%%sp"
+            : "=r"(retvalue)
+            : "g"(n)
+            : "d1", "d2", "a0", "a1", "a2", "cc", "memory");
+        return retvalue;
+    }
+    
+    #define Setcolor(idx, rgb) trap_14_www(7, idx, rgb)
+    #define Vsync() trap_14_w(37)
+    
+    /* test_trap_setcolor_loop - XBIOS calls with live loop state
+     * Current: i and pal live in callee-saved registers (movem save/
+     *   restore) because the asm clobbers d0-d2/a0-a2, and the "memory"
+     *   clobber forces pal[i] to be reloaded after every call
+     * Expected with a trap builtin: Setcolor does not write user memory, so
+     *   loads can be hoisted and scheduled across the trap; the per-call
+     *   addq.l #6,sp folds into the next iteration's pushes
+     */
+    void __attribute__((noinline))
+    test_trap_setcolor_loop(const short *pal) {
+        for (short i = 0; i < 16; i++)
+            Setcolor(i, pal[i]);
+    }
+    
+    /* test_trap_vsync_pair - back-to-back traps
+     * Expected with a trap builtin: both stack cleanups merged into a
+     *   single addq.l #4,sp after the second trap
+     */
+    void __attribute__((noinline))
+    test_trap_vsync_pair() {
+        Vsync();
+        Vsync();
+    }
+    
+    /* ==========================================================================
+     * BYTE HASH TEST CASES (std::_Hash_bytes)
+     *
+     * libsupc++ hash_bytes.cc uses 32-bit MurmurHash2 when size_t is 4 bytes:
+     * three 32x32 multiplies per 4-byte block, each a __mulsi3 libcall on
+     * 68000 (see hash_bytes.cc.345r.m68k-sink-postinc).  The second function
+     * is a multiply-free candidate built from shifts, adds and eor.
+     * See M68K_OPTIMIZATIONS.md Appendix B.15.
+     * ========================================================================== */
+    
+    /* test_hash_murmur2 - libstdc++ _Hash_bytes, 32-bit size_t path
+     * Current for 68000: 3 jsr __mulsi3 per block (k *= m twice,
+     *   hash *= m), plus 2 in the tail/finalizer
+     */
+    unsigned long __attribute__((noinline))
+    test_hash_murmur2(const void *ptr, unsigned long len, unsigned long seed) {
+        const unsigned long m = 0x5bd1e995;
+        unsigned long hash = seed ^ len;
+        const unsigned char *buf = (const unsigned char *)ptr;
+        while (len >= 4) {
+            unsigned long k;
+            __builtin_memcpy(&k, buf, 4);
+            k *= m;
+            k ^= k >> 24;
+            k *= m;
+            hash *= m;
+            hash ^= k;
+            buf += 4;
+            len -= 4;
+        }
+        switch (len) {
+            case 3: hash ^= (unsigned long)buf[2] << 16; [[fallthrough]];
+            case 2: hash ^= (unsigned long)buf[1] << 8;  [[fallthrough]];
+            case 1: hash ^= buf[0];
+                    hash *= m;
+        }
+        hash ^= hash >> 13;
+        hash *= m;
+        hash ^= hash >> 15;
+        return hash;
+    }
+    
+    /* test_hash_oaat - multiply-free byte hash for 68000 (Jenkins one-at-a-time)
+     * Per byte: add.l, shift-add by 10, shift-xor by 6; no libcalls.
+     * Expected for 68000: move.b (a0)+ loop with dbra, ~90 cycles/byte
+     *   versus ~175 cycles/byte for the __mulsi3-based MurmurHash2
+     */
+    unsigned long __attribute__((noinline))
+    test_hash_oaat(const void *ptr, unsigned long len, unsigned long seed) {
+        const unsigned char *buf = (const unsigned char *)ptr;
+        unsigned long hash = seed ^ len;
+        while (len--) {
+            hash += *buf++;
+            hash += hash << 10;
+            hash ^= hash >> 6;
+        }
+        hash += hash << 3;
+        hash ^= hash >> 11;
+        hash += hash << 15;
+        return hash;
+    }
+    
+    /* ==========================================================================
+     * COLDFIRE EMAC TEST CASES (-mcpu=5475)
+     *
+     * The 5475 has an EMAC unit with four 48-bit accumulators (ACC0-ACC3),
+     * but multiply-accumulate loops compile to muls.l/muls.w + add.l on the
+     * integer pipeline.  See M68K_OPTIMIZATIONS.md Appendix B.16.
+     * ========================================================================== */
+    
+    /* test_emac_dot16 - 16x16 dot product
+     * Expected for -mcpu=5475: accumulator cleared before the loop, one
+     *   mac.w (with parallel operand load) per element, movclr.l to fetch
+     *   the sum after the loop
+     */
+    int __attribute__((noinline))
+    test_emac_dot16(const short *a, const short *b, unsigned short n) {
+        int sum = 0;
+        for (unsigned short i = 0; i < n; i++)
+            sum += a[i] * b[i];
+        return sum;
+    }
+    
+    /* test_emac_fir4 - 4-tap FIR filter
+     * Four independent products per output; one accumulator chain.
+     * Expected for -mcpu=5475: 4x mac.w with parallel operand load,
+     *   result via movclr.l, instead of 4x muls.w + 3x add.l
+     */
+    void __attribute__((noinline))
+    test_emac_fir4(const short *x, const short *h, int *y, unsigned short n) {
+        for (unsigned short i = 0; i < n; i++) {
+            y[i] = x[i] * h[0] + x[i + 1] * h[1] + x[i + 2] * h[2] + x[i + 3] * h[3];
+        }
+    }
+    
+    /* test_emac_mix_sub - mixing loop with subtract (msac)
+     * Expected for -mcpu=5475: mac.l for the first product, msac.l for
+     *   the second, both into the same accumulator
+     */
+    void __attribute__((noinline))
+    test_emac_mix_sub(int *out, const int *a, const int *b, int va, int vb, unsigned short n) {
+        for (unsigned short i = 0; i < n; i++)
+            out[i] = a[i] * va - b[i] * vb;
+    }
+    
+    /* ==========================================================================
+     * CODE OUTLINING TEST CASES (-Os)
+     *
+     * Sequences that repeat across many functions at -Os: large movem.l
+     * restore + rts epilogues and fixed-size struct clears.  Outlined into a
+     * shared helper, each occurrence becomes a jsr/jra.  See
+     * M68K_OPTIMIZATIONS.md Appendix B.17.
+     * ========================================================================== */
+    
+    extern void consume4(long a, long b, long c, long d);
+    
+    /* test_outline_epilogue_a / _b - identical 6-register save sets
+     * Current at -Os: movem.l (sp)+,d2-d5/a2-a3 + rts in each function
+     * Expected with shared epilogues: jra __m68k_restore_d2d5a2a3 (4 bytes)
+     */
+    long __attribute__((noinline))
+    test_outline_epilogue_a(long *p, long *q, short n) {
+        long a = p[0], b = p[1], c = q[0], d = q[1];
+        long *r = p + n, *s = q + n;
+        consume4(a, b, c, d);
+        consume4(*r, *s, a, b);
+        return a + b + c + d + *r + *s;
+    }
+    
+    long __attribute__((noinline))
+    test_outline_epilogue_b(long *p, long *q, short n) {
+        long a = p[2], b = p[3], c = q[2], d = q[3];
+        long *r = p - n, *s = q - n;
+        consume4(a, b, c, d);
+        consume4(*r, *s, c, d);
+        return a - b + c - d + *r - *s;
+    }
+    
+    struct outline_rect_s { long x, y, w, h, flags, owner; };
+    
+    /* test_outline_struct_clear - 24-byte clear repeated at several sites
+     * Expected with outlining: lea + jsr __m68k_clear24 per site at -Os
+     *   when the inline clr.l sequence is longer than the call
+     */
+    void __attribute__((noinline))
+    test_outline_struct_clear(struct outline_rect_s *a, struct outline_rect_s *b,
+                              struct outline_rect_s *c) {
+        *a = (struct outline_rect_s){};
+        *b = (struct outline_rect_s){};
+        *c = (struct outline_rect_s){};
+    }
+    
+    /* ==========================================================================
+     * STRING BUILTIN TEST CASES
+     *
+     * Calls to the standard string functions, as opposed to the hand-written
+     * mintlib/libcmini loops above.  Without m68k expanders these are always
+     * jsr calls.  The hand-written versions show the target loop shapes.
+     * See M68K_OPTIMIZATIONS.md Appendix B.18.
+     * ========================================================================== */
+    
+    /* test_builtin_strlen - Expected at -O2: move.l a0,a1; tst.b (a0)+;
+     *   jne; sub.l a1,a0; subq.l #1,a0 (cf. test_libcmini_strlen)
+     */
+    unsigned long __attribute__((noinline))
+    test_builtin_strlen(const char *s) {
+        return __builtin_strlen(s);
+    }
+    
+    /* test_builtin_strcmp - Expected at -O2: CC-reordered byte loop as in
+     *   test_libcmini_strcmp (tested byte loaded last, no tst)
+     */
+    int __attribute__((noinline))
+    test_builtin_strcmp(const char *a, const char *b) {
+        return __builtin_strcmp(a, b);
+    }
+    
+    /* test_builtin_strcpy - Expected at -O2: move.b (a1)+,(a0)+; jne
+     */
+    char * __attribute__((noinline))
+    test_builtin_strcpy(char *dst, const char *src) {
+        return __builtin_strcpy(dst, src);
+    }
+    
+    /* test_builtin_memchr - bounded search with a 16-bit count
+     * Expected at -O2: cmp.b (a0)+,d0; dbeq d1,loop
+     */
+    void * __attribute__((noinline))
+    test_builtin_memchr(const void *p, int c, unsigned short n) {
+        return __builtin_memchr(p, c, n);
+    }
+    
+    /* test_builtin_memcmp - bounded compare with a 16-bit count
+     * Expected at -O2: cmpm.b (a0)+,(a1)+; dbne d0,loop
+     */
+    int __attribute__((noinline))
+    test_builtin_memcmp(const void *a, const void *b, unsigned short n) {
+        return __builtin_memcmp(a, b, n);
+    }
+    
+    /* test_builtin_strlen_const - must stay folded to a constant */
+    unsigned long __attribute__((noinline))
+    test_builtin_strlen_const() {
+        return __builtin_strlen("atari");
+    }
+    
 }
 
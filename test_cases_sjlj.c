@@ -0,0 +1,69 @@
+/* Test cases for sjlj exception registration overhead.
+ *
+ * The sjlj compiler (build-gcc.sh -sjlj) only builds the C front end, so
+ * these live in a separate C file.  build-test_cases.sh -sjlj compiles it
+ * with and without -fexceptions; the difference is the per-function cost of
+ * the setjmp-style registration that sjlj lowering adds to every function
+ * with cleanups.  See M68K_OPTIMIZATIONS.md Appendix B.14.
+ */
+
+#define __cleanup(f) __attribute__((cleanup(f)))
+
+extern void may_throw(int v);
+extern void release(int *p);
+extern int nothrow_query(int v) __attribute__((nothrow));
+
+/* test_sjlj_single_cleanup - one cleanup, one throwing call
+ * Baseline cost: _Unwind_SjLj_Register on entry, call-site index store
+ *   before the jsr, _Unwind_SjLj_Unregister on exit.
+ */
+void test_sjlj_single_cleanup(int a) {
+    int r __cleanup(release) = a;
+    may_throw(r);
+}
+
+/* test_sjlj_cold_call - throwing call only on an unlikely path
+ * Current: registration on entry even when the hot path never calls out.
+ * Expected with lazy registration: register/unregister sunk into the cold
+ *   block, hot path has no sjlj overhead.
+ */
+int test_sjlj_cold_call(int a) {
+    int r __cleanup(release) = a;
+    if (__builtin_expect(a < 0, 0))
+        may_throw(a);
+    return r * 2;
+}
+
+/* test_sjlj_nothrow_only - cleanup but only nothrow calls
+ * Expected: no registration at all (no call site can unwind).
+ */
+int test_sjlj_nothrow_only(int a) {
+    int r __cleanup(release) = a;
+    return nothrow_query(r) + nothrow_query(a);
+}
+
+/* test_sjlj_live_across - values live across the throwing call
+ * The registration saves the full jmp_buf context; only x, y and z are
+ *   live across may_throw, so a minimal save would be 3 registers.
+ */
+int test_sjlj_live_across(int a, int b, int c) {
+    int r __cleanup(release) = a;
+    int x = a * 3, y = b + c, z = c - a;
+    may_throw(r);
+    return x + y + z;
+}
+
+static inline __attribute__((always_inline)) void
+sjlj_helper(int v) {
+    int h __cleanup(release) = v;
+    may_throw(h);
+}
+
+/* test_sjlj_inlined_regions - two inlined regions with cleanups
+ * Expected with merged registrations: one register/unregister pair for
+ *   the whole function, only call-site indices differ.
+ */
+void test_sjlj_inlined_regions(int a, int b) {
+    sjlj_helper(a);
+    sjlj_helper(b);
+}